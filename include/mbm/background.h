@@ -1,17 +1,20 @@
 #ifndef MBM_BACKGROUND_H_INCLUDED
 #define MBM_BACKGROUND_H_INCLUDED
 #include "mbm/abi.h"
-#include "mbm/timings.h"          // struct timings and associated functions
+#include "mbm/dims.h"             // struct dims
 #include "SDL3/SDL_render.h"      // SDL_Renderer
 
 // `struct background` is an opaque data structure;
 // only the implementation has access to its layout
 struct background;
 
+// `struct camera` follows the player's duck through the level; see src/mbm/camera.h
+struct camera;
+
 MBM_ABI void background_delete (struct background ** self);
 MBM_ABI void background_draw (const struct background * self, SDL_Renderer * renderer);
-MBM_ABI void background_init (struct background * self);
+MBM_ABI void background_init (struct background * self, SDL_Renderer * renderer, const struct dims * dims);
 MBM_ABI struct background * background_new (void);
-MBM_ABI void background_update (struct background * self, const struct timings * timings);
+MBM_ABI void background_update (struct background * self, const struct camera * camera);
 
 #endif
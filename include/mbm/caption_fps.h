@@ -8,11 +8,18 @@
 // only the implementation has access to its layout
 struct caption_fps;
 
+// `struct resources` shares reference-counted textures and fonts; see src/mbm/resources.h
+struct resources;
+
+// `struct sprites` collects the quads of a frame and draws them in few calls; see src/mbm/sprites.h
+struct sprites;
+
 MBM_ABI void caption_fps_delete (struct caption_fps ** self);
-MBM_ABI void caption_fps_draw (const struct caption_fps * self, SDL_Renderer * renderer);
-MBM_ABI void caption_fps_init (struct caption_fps * self);
+MBM_ABI void caption_fps_draw (const struct caption_fps * self, struct sprites * sprites);
+MBM_ABI void caption_fps_init (struct caption_fps * self, SDL_Renderer * renderer, struct resources * resources);
 MBM_ABI struct caption_fps * caption_fps_new (void);
 MBM_ABI void caption_fps_toggle (struct caption_fps * self);
-MBM_ABI void caption_fps_update (struct caption_fps * self, const struct timings * timings);
+MBM_ABI void caption_fps_toggle_graph (struct caption_fps * self);
+MBM_ABI bool caption_fps_update (struct caption_fps * self, const struct timings * timings, const struct sprites * sprites);
 
 #endif
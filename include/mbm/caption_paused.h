@@ -2,15 +2,21 @@
 #define MBM_CAPTION_PAUSED_H_INCLUDED
 #include "mbm/abi.h"
 #include "mbm/world.h"            // struct world and associated functions
-#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture
+#include "SDL3/SDL_render.h"      // SDL_Renderer
 
 // `struct caption_paused` is an opaque data structure;
 // only the implementation has access to its layout
 struct caption_paused;
 
+// `struct resources` shares reference-counted textures and fonts; see src/mbm/resources.h
+struct resources;
+
+// `struct sprites` collects the quads of a frame and draws them in few calls; see src/mbm/sprites.h
+struct sprites;
+
 MBM_ABI void caption_paused_delete (struct caption_paused ** self);
-MBM_ABI void caption_paused_draw (const struct caption_paused * self, SDL_Renderer * renderer);
-MBM_ABI void caption_paused_init (struct caption_paused * self, SDL_Renderer * renderer, const struct dims * dims);
+MBM_ABI void caption_paused_draw (const struct caption_paused * self, struct sprites * sprites);
+MBM_ABI void caption_paused_init (struct caption_paused * self, SDL_Renderer * renderer, struct resources * resources, const struct dims * dims);
 MBM_ABI struct caption_paused * caption_paused_new (void);
 MBM_ABI void caption_paused_update (struct caption_paused * self);
 
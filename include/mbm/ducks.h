@@ -0,0 +1,36 @@
+#ifndef MBM_DUCKS_H_INCLUDED
+#define MBM_DUCKS_H_INCLUDED
+#include "mbm/abi.h"
+#include "mbm/timings.h"          // struct timings and associated functions
+#include "mbm/world.h"            // struct world and associated functions
+#include "SDL3/SDL_rect.h"        // SDL_FRect
+
+// `struct ducks` is an opaque data structure that holds any number of ducks;
+// only the implementation has access to its layout. Individual ducks are
+// identified by the index that ducks_spawn() returns.
+struct ducks;
+
+// `struct atlas` holds the packed sprite sheets; see src/mbm/atlas.h
+struct atlas;
+
+// `struct camera` follows the player's duck through the level; see src/mbm/camera.h
+struct camera;
+
+// `struct sprites` collects the quads of a frame and draws them in few calls; see src/mbm/sprites.h
+struct sprites;
+
+MBM_ABI void ducks_delete (struct ducks ** self);
+MBM_ABI void ducks_draw (const struct ducks * self, struct sprites * sprites, const struct camera * camera);
+MBM_ABI SDL_FRect ducks_get_bbox (const struct ducks * self, int iduck);
+MBM_ABI void ducks_halt (struct ducks * self, int iduck);
+MBM_ABI void ducks_handle_collision_with_world (struct ducks * self, const struct world * world);
+MBM_ABI void ducks_init (struct ducks * self, const struct atlas * atlas, int nducks_cap);
+MBM_ABI void ducks_interpolate (struct ducks * self, float alpha);
+MBM_ABI void ducks_jump (struct ducks * self, int iduck);
+MBM_ABI struct ducks * ducks_new (void);
+MBM_ABI int ducks_spawn (struct ducks * self, float x, float y, bool is_wandering);
+MBM_ABI void ducks_update (struct ducks * self, const struct world * world, const struct timings * timings);
+MBM_ABI void ducks_walk_left (struct ducks * self, int iduck);
+MBM_ABI void ducks_walk_right (struct ducks * self, int iduck);
+
+#endif
@@ -17,7 +17,14 @@ MBM_ABI void game_delete (struct game ** self);
 MBM_ABI void game_draw (const struct game * self, SDL_Renderer * renderer);
 MBM_ABI SDL_AppResult game_handle_event (struct game * self, SDL_Renderer * renderer, const SDL_Event * event);
 MBM_ABI void game_init (struct game * self, SDL_Renderer * renderer, const struct dims * dims);
+MBM_ABI bool game_is_dirty (const struct game * self);
+MBM_ABI bool game_is_loading (const struct game * self);
+MBM_ABI bool game_is_replay_done (const struct game * self);
 MBM_ABI struct game * game_new (void);
-MBM_ABI void game_update (struct game * self, const struct timings * timings);
+MBM_ABI void game_record_input (struct game * self, const char * path);
+MBM_ABI void game_replay_input (struct game * self, const char * path);
+MBM_ABI void game_set_target_rate (struct game * self, SDL_Renderer * renderer, int rate);
+MBM_ABI void game_spawn_ducks (struct game * self, int nducks);
+MBM_ABI void game_update (struct game * self, struct timings * timings);
 
 #endif
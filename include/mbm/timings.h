@@ -7,11 +7,26 @@
 // only the implementation has access to its layout
 struct timings;
 
+MBM_ABI void timings_advance (struct timings * self, int64_t duration);
 MBM_ABI void timings_delete (struct timings ** self);
 MBM_ABI float timings_get_frame_duration (const struct timings * self);
+MBM_ABI float timings_get_frame_duration_avg (const struct timings * self);
+MBM_ABI float timings_get_frame_duration_max (const struct timings * self);
+MBM_ABI float timings_get_frame_duration_min (const struct timings * self);
+MBM_ABI float timings_get_frame_duration_p99 (const struct timings * self);
+MBM_ABI int timings_get_frame_durations (const struct timings * self, float * durations, int ndurations_cap);
 MBM_ABI int64_t timings_get_frame_timestamp (const struct timings * self);
+MBM_ABI int timings_get_nmissed (const struct timings * self);
+MBM_ABI float timings_get_tick_alpha (const struct timings * self);
+MBM_ABI float timings_get_tick_duration (const struct timings * self);
+MBM_ABI int64_t timings_get_tick_timestamp (const struct timings * self);
+MBM_ABI void timings_idle (struct timings * self);
 MBM_ABI void timings_init (struct timings * self);
 MBM_ABI struct timings * timings_new (void);
+MBM_ABI void timings_pace (struct timings * self);
+MBM_ABI void timings_set_target_rate (struct timings * self, int rate);
+MBM_ABI void timings_set_tick_rate (struct timings * self, int rate);
+MBM_ABI bool timings_tick (struct timings * self);
 MBM_ABI void timings_update (struct timings * self);
 
 #endif
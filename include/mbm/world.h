@@ -2,20 +2,29 @@
 #define MBM_WORLD_H_INCLUDED
 #include "mbm/abi.h"
 #include "mbm/dims.h"             // struct dims
-#include "mbm/timings.h"          // struct timings and associated functions
-#include "SDL3/SDL_rect.h"        // SDL_FRect
-#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
 
 // `struct world` is an opaque data structure;
 // only the implementation has access to its layout
 struct world;
 
+// `struct atlas` holds the packed sprite sheets; see src/mbm/atlas.h
+struct atlas;
+
+// `struct camera` follows the player's duck through the level; see src/mbm/camera.h
+struct camera;
+
+// `struct sprites` collects the quads of a frame and draws them in few calls; see src/mbm/sprites.h
+struct sprites;
+
 MBM_ABI void world_delete (struct world ** self);
-MBM_ABI void world_draw (const struct world * self, SDL_Renderer * renderer);
+MBM_ABI void world_draw (const struct world * self, struct sprites * sprites, const struct camera * camera);
 MBM_ABI SDL_FRect world_get_bbox (const struct world * self);
 MBM_ABI float world_get_gravity (const struct world * self);
-MBM_ABI void world_init (struct world * self, SDL_Renderer * renderer, const struct dims * dims);
+MBM_ABI void world_init (struct world * self, const struct atlas * atlas, const struct dims * dims);
 MBM_ABI struct world * world_new (void);
-MBM_ABI void world_update (struct world * self, const struct timings * timings);
+MBM_ABI SDL_FPoint world_resolve_penetration (const struct world * self, SDL_FRect aabb);
+MBM_ABI float world_sweep_aabb (const struct world * self, SDL_FRect aabb, SDL_FPoint delta, SDL_FPoint * normal);
+MBM_ABI void world_update (struct world * self, const struct camera * camera);
 
 #endif
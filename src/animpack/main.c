@@ -0,0 +1,124 @@
+#include "animfile.h"             // struct animfile_header, ANIMFILE_*
+#include <stdint.h>               // int32_t, int64_t, uint8_t, uint32_t
+#include <stdio.h>                // FILE, fopen, fgets, fwrite, fprintf, sscanf
+#include <stdlib.h>               // calloc, realloc, free, exit
+#include <string.h>               // memcpy, strncmp
+
+// `animpack` converts a text description of a sprite sheet's animations into the binary format
+// described in animfile.h. Each line of the description is either empty, a comment starting with
+// '#', `anim <name>` to start a new animation, or `frame <duration> <x> <y> <w> <h>` to append a
+// frame lasting <duration> microseconds to the current animation.
+
+struct frame {
+    int64_t duration;                         // microseconds
+    float src[4];                             // x, y, w, h
+    int ianim;
+};
+
+// forward declaration of static functions
+static uint32_t align_up (uint32_t n);
+static void die (const char * msg, const char * path, int iline);
+
+static uint32_t align_up (uint32_t n) {
+    return (n + ANIMFILE_ALIGNMENT - 1) / ANIMFILE_ALIGNMENT * ANIMFILE_ALIGNMENT;
+}
+
+static void die (const char * msg, const char * path, int iline) {
+    fprintf(stderr, "animpack: %s:%d: %s, aborting.\n", path, iline, msg);
+    exit(1);
+}
+
+int main (int argc, char * argv[]) {
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: animpack INPUT OUTPUT\n");
+        exit(1);
+    }
+    const char * ipath = argv[1];
+    const char * opath = argv[2];
+
+    // read the frames from the description
+    struct frame * frames = nullptr;
+    int nframes = 0;
+    int nframes_cap = 0;
+    int nanims = 0;
+    {
+        FILE * istream = fopen(ipath, "r");
+        if (istream == nullptr) die("couldn't open file for reading", ipath, 0);
+        char line[256];
+        int iline = 0;
+        while (fgets(line, sizeof(line), istream) != nullptr) {
+            iline++;
+            char word[16] = "";
+            if (sscanf(line, "%15s", word) != 1 || word[0] == '#') continue;
+            if (strncmp(word, "anim", sizeof(word)) == 0) {
+                nanims++;
+                continue;
+            }
+            if (strncmp(word, "frame", sizeof(word)) != 0) die("expected 'anim' or 'frame'", ipath, iline);
+            if (nanims == 0) die("'frame' before the first 'anim'", ipath, iline);
+            if (nframes == nframes_cap) {
+                nframes_cap = nframes_cap == 0 ? 16 : 2 * nframes_cap;
+                frames = realloc(frames, nframes_cap * sizeof(struct frame));
+                if (frames == nullptr) die("couldn't allocate memory for frames", ipath, iline);
+            }
+            struct frame * f = &frames[nframes];
+            long long duration = 0;
+            if (sscanf(line, "%*s %lld %f %f %f %f", &duration, &f->src[0], &f->src[1], &f->src[2], &f->src[3]) != 5) {
+                die("expected 'frame <duration> <x> <y> <w> <h>'", ipath, iline);
+            }
+            if (duration <= 0) die("frame duration should be positive", ipath, iline);
+            f->duration = (int64_t) duration;
+            f->ianim = nanims - 1;
+            nframes++;
+        }
+        fclose(istream);
+    }
+
+    // lay out the file
+    struct animfile_header header = {
+        .magic = { ANIMFILE_MAGIC[0], ANIMFILE_MAGIC[1], ANIMFILE_MAGIC[2], ANIMFILE_MAGIC[3] },
+        .version = ANIMFILE_VERSION,
+        .nanims = (uint32_t) nanims,
+        .nframes = (uint32_t) nframes,
+    };
+    header.offset_durations = align_up(sizeof(struct animfile_header));
+    header.offset_frame_offsets = align_up(header.offset_durations + nanims * sizeof(int64_t));
+    header.offset_nframes = align_up(header.offset_frame_offsets + nanims * sizeof(int32_t));
+    header.offset_frame_ends = align_up(header.offset_nframes + nanims * sizeof(int32_t));
+    header.offset_frame_srcs = align_up(header.offset_frame_ends + nframes * sizeof(int64_t));
+    header.size = align_up(header.offset_frame_srcs + nframes * 4 * sizeof(float));
+
+    // fill the arrays
+    uint8_t * block = calloc(1, header.size);
+    if (block == nullptr) die("couldn't allocate memory for output", opath, 0);
+    int64_t * durations = (int64_t *) &block[header.offset_durations];
+    int32_t * frame_offsets = (int32_t *) &block[header.offset_frame_offsets];
+    int32_t * nframes_per_anim = (int32_t *) &block[header.offset_nframes];
+    int64_t * frame_ends = (int64_t *) &block[header.offset_frame_ends];
+    float * frame_srcs = (float *) &block[header.offset_frame_srcs];
+    for (int i = 0; i < nframes; i++) {
+        const int ianim = frames[i].ianim;
+        if (nframes_per_anim[ianim] == 0) {
+            frame_offsets[ianim] = i;
+        }
+        durations[ianim] += frames[i].duration;
+        frame_ends[i] = durations[ianim];
+        memcpy(&frame_srcs[4 * i], frames[i].src, 4 * sizeof(float));
+        nframes_per_anim[ianim]++;
+    }
+    for (int ianim = 0; ianim < nanims; ianim++) {
+        if (nframes_per_anim[ianim] == 0) die("animation without frames", ipath, 0);
+    }
+    memcpy(block, &header, sizeof(struct animfile_header));
+
+    // write the file in one go
+    FILE * ostream = fopen(opath, "wb");
+    if (ostream == nullptr) die("couldn't open file for writing", opath, 0);
+    if (fwrite(block, 1, header.size, ostream) != header.size) die("couldn't write file", opath, 0);
+    fclose(ostream);
+
+    free(block);
+    free(frames);
+    return 0;
+}
@@ -4,22 +4,47 @@
 #include "mbm/timings.h"          // struct timings and associated functions
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_events.h"      // SDL_Event
+#include "SDL3/SDL_hints.h"       // SDL_SetHint, SDL_HINT_VIDEO_DRIVER, SDL_HINT_RENDER_DRIVER
 #include "SDL3/SDL_init.h"        // SDL_InitFlags, SDL_AppResult, defines
-#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_keycode.h"     // SDL_Keycode, SDLK_*
+#include "SDL3/SDL_log.h"         // SDL_LogCritical, SDL_Log
 #define SDL_MAIN_USE_CALLBACKS 1  // use the callbacks instead of main()
 #include "SDL3/SDL_main.h"        // definition of main() that calls the callback functions
 #include "SDL3/SDL_render.h"      // SDL_Renderer
-#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc
-#include "SDL3/SDL_timer.h"       // SDL_GetTicksNS
+#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc, SDL_qsort, SDL_strcmp, SDL_strtol
+#include "SDL3/SDL_timer.h"       // SDL_Delay, SDL_GetTicksNS
 #include "SDL3/SDL_video.h"       // SDL_Window, SDL_WindowFlags, defines
 #include "SDL3/SDL.h"
 #include "SDL3_ttf/SDL_ttf.h"     // TTF_Init, TTF_Quit
+#include <stdint.h>               // int64_t
 #include <stdlib.h>               // atexit, exit
 
+// longest time to wait for events while the frame doesn't need redrawing, such that the game still
+// gets updated now and then
+#define MBM_IDLE_TIMEOUT_MS 100
+
+// scripted input for benchmark runs: at frame `iframe` (modulo the script's period), `key` goes
+// down or up
+struct bench_step {
+    int iframe;
+    SDL_Keycode key;
+    bool down;
+};
+
 // forward declaration of static functions
+static int compare_int64 (const void * a, const void * b);
 static void init_sdl_subsystems (SDL_InitFlags flags);
 static void init_sdl_window_and_renderer (SDL_WindowFlags flags, struct dims * dims,
                                           SDL_Renderer ** renderer, SDL_Window ** window);
+static int parse_option_count (int argc, char * argv[], const char * name);
+static const char * parse_option_path (int argc, char * argv[], const char * name);
+static void run_bench (struct appstate * appstate, int nframes, bool is_scripted);
+
+static int compare_int64 (const void * a, const void * b) {
+    const int64_t va = *(const int64_t *) a;
+    const int64_t vb = *(const int64_t *) b;
+    return (va > vb) - (va < vb);
+}
 
 static void init_sdl_subsystems (SDL_InitFlags flags) {
     bool success = SDL_Init(flags);
@@ -45,6 +70,110 @@ static void init_sdl_window_and_renderer (SDL_WindowFlags flags, struct dims * d
     SDL_SetRenderLogicalPresentation(*renderer, dims->view.w, dims->view.h, SDL_LOGICAL_PRESENTATION_LETTERBOX);
 }
 
+static int parse_option_count (int argc, char * argv[], const char * name) {
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], name) != 0) continue;
+        const int count = i + 1 < argc ? (int) SDL_strtol(argv[i + 1], nullptr, 10) : 0;
+        if (count <= 0) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Usage: mbm [--bench N] [--ducks M] [--fps F] [--record FILE | --replay FILE], with N "
+                            "a positive number of frames, M a positive number of ducks and F a positive "
+                            "frame rate, aborting.\n");
+            exit(1);
+        }
+        return count;
+    }
+    return 0;
+}
+
+static const char * parse_option_path (int argc, char * argv[], const char * name) {
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], name) != 0) continue;
+        if (i + 1 >= argc) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Usage: mbm [--bench N] [--ducks M] [--fps F] [--record FILE | --replay FILE], with N "
+                            "a positive number of frames, M a positive number of ducks and F a positive "
+                            "frame rate, aborting.\n");
+            exit(1);
+        }
+        return argv[i + 1];
+    }
+    return nullptr;
+}
+
+static void run_bench (struct appstate * appstate, int nframes, bool is_scripted) {
+
+    // walk right, jump, walk left, jump, repeat
+    static const struct bench_step script[] = {
+        { .iframe =   0, .key = SDLK_RIGHT, .down = true  },
+        { .iframe = 120, .key = SDLK_SPACE, .down = true  },
+        { .iframe = 121, .key = SDLK_SPACE, .down = false },
+        { .iframe = 240, .key = SDLK_RIGHT, .down = false },
+        { .iframe = 241, .key = SDLK_LEFT,  .down = true  },
+        { .iframe = 360, .key = SDLK_SPACE, .down = true  },
+        { .iframe = 361, .key = SDLK_SPACE, .down = false },
+        { .iframe = 480, .key = SDLK_LEFT,  .down = false },
+    };
+    const int period = 481;
+    const int nsteps = (int) SDL_arraysize(script);
+
+    // advance the game clock by the same amount every frame, such that every run simulates the
+    // same workload regardless of how fast the machine is
+    const int64_t frame_duration = (int64_t) 16667;  // microseconds
+
+    int64_t * durations = (int64_t *) SDL_calloc(nframes, sizeof(int64_t));
+    if (durations == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Could not allocate dynamic memory for benchmark frame durations, aborting: %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+
+    // let the assets finish loading before measuring anything
+    while (game_is_loading(appstate->game)) {
+        timings_update(appstate->timings);
+        game_update(appstate->game, appstate->timings);
+        SDL_Delay(1);
+    }
+
+    const Uint64 tstart = SDL_GetTicksNS();
+    for (int iframe = 0; iframe < nframes; iframe++) {
+        const Uint64 tframe = SDL_GetTicksNS();
+        for (int istep = 0; is_scripted && istep < nsteps; istep++) {
+            if (script[istep].iframe != iframe % period) continue;
+            SDL_Event event = {};
+            event.key.type = script[istep].down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+            event.key.key = script[istep].key;
+            event.key.down = script[istep].down;
+            game_handle_event(appstate->game, appstate->renderer, &event);
+        }
+        timings_advance(appstate->timings, frame_duration);
+        game_update(appstate->game, appstate->timings);
+        game_draw(appstate->game, appstate->renderer);
+        SDL_RenderPresent(appstate->renderer);
+        durations[iframe] = (int64_t) (SDL_GetTicksNS() - tframe);
+    }
+    const Uint64 ttotal = SDL_GetTicksNS() - tstart;
+
+    // report frame time statistics in microseconds
+    SDL_qsort(durations, nframes, sizeof(int64_t), compare_int64);
+    double sum = 0.0;
+    for (int iframe = 0; iframe < nframes; iframe++) {
+        sum += (double) durations[iframe];
+    }
+    SDL_Log("bench: %d frames using the '%s' renderer\n", nframes, SDL_GetRendererName(appstate->renderer));
+    SDL_Log("bench: frame time min  %10.1f us\n", durations[0] / 1e3);
+    SDL_Log("bench: frame time mean %10.1f us\n", sum / nframes / 1e3);
+    SDL_Log("bench: frame time p50  %10.1f us\n", durations[(nframes - 1) * 50 / 100] / 1e3);
+    SDL_Log("bench: frame time p95  %10.1f us\n", durations[(nframes - 1) * 95 / 100] / 1e3);
+    SDL_Log("bench: frame time p99  %10.1f us\n", durations[(nframes - 1) * 99 / 100] / 1e3);
+    SDL_Log("bench: frame time max  %10.1f us\n", durations[nframes - 1] / 1e3);
+    SDL_Log("bench: wall time       %10.1f ms\n", ttotal / 1e6);
+
+    SDL_free(durations);
+    durations = nullptr;
+}
+
 // `SDL_AppEvent` runs when a new event (mouse input, keypresses, etc) occurs
 SDL_AppResult SDL_AppEvent(void * appstate_vp, SDL_Event * event) {
     // make the void pointer appstate_vp usable by casting it as a struct appstate pointer
@@ -55,9 +184,24 @@ SDL_AppResult SDL_AppEvent(void * appstate_vp, SDL_Event * event) {
 // `SDL_AppInit` runs once at startup`
 SDL_AppResult SDL_AppInit(void ** appstate_vpp, int argc, char * argv[]) {
 
-    // define argc and argv as unused
-    (void) argc;
-    (void) argv;
+    // `--bench N` runs N frames on a hidden window and reports frame time statistics
+    const int nframes_bench = parse_option_count(argc, argv, "--bench");
+
+    // `--ducks M` adds M wandering ducks to the level, e.g. to benchmark a larger population
+    const int nducks_extra = parse_option_count(argc, argv, "--ducks");
+
+    // `--fps F` paces frames at F per second, by sleeping and then spinning until each deadline
+    const int fps = parse_option_count(argc, argv, "--fps");
+
+    // `--record FILE` writes the player's input per simulation tick to FILE on exit, and
+    // `--replay FILE` feeds it back instead of the live input, then quits
+    const char * path_record = parse_option_path(argc, argv, "--record");
+    const char * path_replay = parse_option_path(argc, argv, "--replay");
+    if (path_record != nullptr && path_replay != nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Options --record and --replay can't be combined, aborting.\n");
+        exit(1);
+    }
 
     struct dims dims = (struct dims) {
         .tile = {
@@ -84,7 +228,15 @@ SDL_AppResult SDL_AppInit(void ** appstate_vpp, int argc, char * argv[]) {
     SDL_Window * window = nullptr;
 
     const SDL_InitFlags init_flags = SDL_INIT_VIDEO | SDL_INIT_EVENTS;
-    const SDL_WindowFlags window_flags = SDL_WINDOW_BORDERLESS | SDL_WINDOW_RESIZABLE;
+    SDL_WindowFlags window_flags = SDL_WINDOW_BORDERLESS | SDL_WINDOW_RESIZABLE;
+
+    if (nframes_bench > 0) {
+        // render into memory with the software renderer, such that benchmarks run the same with
+        // or without a display
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+        window_flags |= SDL_WINDOW_HIDDEN;
+    }
 
     // register SDL_Quit function to run at exit
     atexit(SDL_Quit);
@@ -108,6 +260,14 @@ SDL_AppResult SDL_AppInit(void ** appstate_vpp, int argc, char * argv[]) {
     // initialize the game object
     game = game_new();
     game_init(game, renderer, &dims);
+    game_set_target_rate(game, renderer, fps);
+    game_spawn_ducks(game, nducks_extra);
+    if (path_record != nullptr) {
+        game_record_input(game, path_record);
+    }
+    if (path_replay != nullptr) {
+        game_replay_input(game, path_replay);
+    }
 
     // facilitate sharing state between callbacks via void ** appstate_vpp
     *appstate_vpp = (void *) SDL_calloc(1, sizeof(struct appstate));
@@ -125,6 +285,13 @@ SDL_AppResult SDL_AppInit(void ** appstate_vpp, int argc, char * argv[]) {
     (*appstate)->timings = timings;
     (*appstate)->window = window;
 
+    if (nframes_bench > 0) {
+        // don't let vsync throttle the benchmark, then run it and quit
+        SDL_SetRenderVSync(renderer, SDL_RENDERER_VSYNC_DISABLED);
+        run_bench(*appstate, nframes_bench, path_replay == nullptr);
+        return SDL_APP_SUCCESS;
+    }
+
     // continue with the rest of the program
     return SDL_APP_CONTINUE;
 }
@@ -146,14 +313,27 @@ SDL_AppResult SDL_AppIterate(void * appstate_vp) {
     // update relevant objects
     game_update(game, timings);
 
+    // a replay ends when its input runs out
+    if (game_is_replay_done(game)) {
+        return SDL_APP_SUCCESS;
+    }
+
+    // when the frame would look the same as the one on screen, don't render or present it, but
+    // block until an event arrives or the timeout passes
+    if (!game_is_dirty(game)) {
+        SDL_WaitEventTimeout(nullptr, MBM_IDLE_TIMEOUT_MS);
+        timings_idle(timings);
+        return SDL_APP_CONTINUE;
+    }
+
     // draw relevant objects
     game_draw(game, renderer);
 
     // update the screen with this frame's rendering
     SDL_RenderPresent(renderer);
 
-    // make sure frames last at least 1 microsecond to avoid numerical problems with integration
-    SDL_DelayNS(1000);
+    // wait for the end of the frame, if frames are paced
+    timings_pace(timings);
 
     return SDL_APP_CONTINUE;
 }
@@ -0,0 +1,349 @@
+#include "atlasfile.h"            // struct atlasfile_header, struct atlasfile_rect, ATLASFILE_*
+#include <stdint.h>               // int32_t, uint8_t, uint16_t, uint32_t
+#include <stdio.h>                // FILE, fopen, fgets, fread, fwrite, fprintf, snprintf, sscanf
+#include <stdlib.h>               // calloc, realloc, free, exit
+#include <string.h>               // memcpy, strlen, strncmp, strrchr
+
+// `atlaspack` packs sprite sheets into a single atlas image, and writes a table with the
+// rectangle that each sheet occupies in the atlas in the format described in atlasfile.h. Each
+// line of the description is either empty, a comment starting with '#', or
+// `sheet <name> <file> [mirrored]`, with <file> a 24 or 32 bit BMP image relative to the
+// description's directory. Sheets marked `mirrored` are packed a second time, flipped
+// horizontally, so that sprites can face either way without being flipped when drawn.
+
+// sheets are kept this many transparent pixels apart, and away from the atlas' edges
+#define ATLASPACK_PADDING 2
+
+// the atlas is square-ish, with a power of two width of at least this many pixels
+#define ATLASPACK_WIDTH_MIN 64
+
+#define ATLASPACK_NSHEETS_MAX 32
+
+struct sheet {
+    int h;
+    bool is_mirrored;
+    char name[ATLASFILE_NAME_CAP];
+    uint32_t * pixels;                        // ARGB, top row first
+    int w;
+};
+
+// one rectangle in the atlas; a mirrored sheet is placed twice
+struct placement {
+    int isheet;
+    bool is_mirrored;
+    int x;
+    int y;
+};
+
+// forward declaration of static functions
+static void die (const char * msg, const char * path, int iline);
+static uint32_t get_channel (uint32_t value, uint32_t mask);
+static uint32_t get_u16 (const uint8_t * bytes);
+static uint32_t get_u32 (const uint8_t * bytes);
+static int pack (struct placement * placements, int nplacements, const struct sheet * sheets, int w);
+static void put_u16 (uint8_t * bytes, uint32_t value);
+static void put_u32 (uint8_t * bytes, uint32_t value);
+static uint32_t * read_bmp (const char * path, int * w, int * h);
+static void write_bmp (const char * path, const uint32_t * pixels, int w, int h);
+
+static void die (const char * msg, const char * path, int iline) {
+    fprintf(stderr, "atlaspack: %s:%d: %s, aborting.\n", path, iline, msg);
+    exit(1);
+}
+
+static uint32_t get_channel (uint32_t value, uint32_t mask) {
+    // extract an 8-bit channel; an absent channel reads as fully set, i.e. opaque for alpha
+    if (mask == 0) return 0xFF;
+    uint32_t shift = 0;
+    while (((mask >> shift) & 1) == 0) {
+        shift++;
+    }
+    return ((value & mask) >> shift) & 0xFF;
+}
+
+static uint32_t get_u16 (const uint8_t * bytes) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8;
+}
+
+static uint32_t get_u32 (const uint8_t * bytes) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+static int pack (struct placement * placements, int nplacements, const struct sheet * sheets, int w) {
+
+    // shelf packing, with the placements sorted by decreasing height beforehand; returns the
+    // height of the atlas, or -1 if a sheet doesn't fit `w`
+    int x = ATLASPACK_PADDING;
+    int y = ATLASPACK_PADDING;
+    int hrow = 0;
+    for (int i = 0; i < nplacements; i++) {
+        const struct sheet * sheet = &sheets[placements[i].isheet];
+        if (sheet->w + 2 * ATLASPACK_PADDING > w) return -1;
+        if (x + sheet->w + ATLASPACK_PADDING > w) {
+            x = ATLASPACK_PADDING;
+            y += hrow + ATLASPACK_PADDING;
+            hrow = 0;
+        }
+        placements[i].x = x;
+        placements[i].y = y;
+        x += sheet->w + ATLASPACK_PADDING;
+        hrow = hrow > sheet->h ? hrow : sheet->h;
+    }
+    return y + hrow + ATLASPACK_PADDING;
+}
+
+static void put_u16 (uint8_t * bytes, uint32_t value) {
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+}
+
+static void put_u32 (uint8_t * bytes, uint32_t value) {
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+    bytes[2] = (uint8_t) (value >> 16);
+    bytes[3] = (uint8_t) (value >> 24);
+}
+
+static uint32_t * read_bmp (const char * path, int * w, int * h) {
+
+    // read the whole file
+    FILE * istream = fopen(path, "rb");
+    if (istream == nullptr) die("couldn't open image for reading", path, 0);
+    uint8_t * bytes = nullptr;
+    size_t nbytes = 0;
+    size_t nbytes_cap = 0;
+    for (;;) {
+        if (nbytes == nbytes_cap) {
+            nbytes_cap = nbytes_cap == 0 ? 65536 : 2 * nbytes_cap;
+            bytes = realloc(bytes, nbytes_cap);
+            if (bytes == nullptr) die("couldn't allocate memory for image", path, 0);
+        }
+        const size_t nread = fread(&bytes[nbytes], 1, nbytes_cap - nbytes, istream);
+        if (nread == 0) break;
+        nbytes += nread;
+    }
+    fclose(istream);
+
+    // check the headers; BMP stores its numbers little-endian
+    if (nbytes < 54 || bytes[0] != 'B' || bytes[1] != 'M') die("not a BMP image", path, 0);
+    const uint32_t offset_pixels = get_u32(&bytes[10]);
+    const uint32_t dib_size = get_u32(&bytes[14]);
+    const int32_t width = (int32_t) get_u32(&bytes[18]);
+    const int32_t height = (int32_t) get_u32(&bytes[22]);
+    const uint32_t bpp = get_u16(&bytes[28]);
+    const uint32_t compression = get_u32(&bytes[30]);
+    const bool is_bitfields = compression == 3 || compression == 6;
+    if (compression != 0 && !is_bitfields) die("compressed BMP images aren't supported", path, 0);
+    if (bpp != 24 && bpp != 32) die("only 24 and 32 bit BMP images are supported", path, 0);
+    if (width <= 0 || height == 0) die("image has no pixels", path, 0);
+
+    // the channel masks follow the 40 byte info header, or are part of the larger headers
+    uint32_t mask_r = 0x00FF0000;
+    uint32_t mask_g = 0x0000FF00;
+    uint32_t mask_b = 0x000000FF;
+    uint32_t mask_a = 0;
+    if (is_bitfields) {
+        if (nbytes < 66) die("image is truncated", path, 0);
+        mask_r = get_u32(&bytes[54]);
+        mask_g = get_u32(&bytes[58]);
+        mask_b = get_u32(&bytes[62]);
+        if (dib_size >= 56 || compression == 6) {
+            if (nbytes < 70) die("image is truncated", path, 0);
+            mask_a = get_u32(&bytes[66]);
+        }
+    }
+
+    // convert the rows to ARGB, top row first; positive heights are stored bottom row first
+    *w = width;
+    *h = height > 0 ? height : -height;
+    const size_t stride = ((size_t) bpp * (size_t) *w + 31) / 32 * 4;
+    if (offset_pixels + stride * (size_t) *h > nbytes) die("image is truncated", path, 0);
+    uint32_t * pixels = calloc((size_t) *w * (size_t) *h, sizeof(uint32_t));
+    if (pixels == nullptr) die("couldn't allocate memory for pixels", path, 0);
+    for (int irow = 0; irow < *h; irow++) {
+        const int irow_file = height > 0 ? *h - 1 - irow : irow;
+        const uint8_t * row = &bytes[offset_pixels + (size_t) irow_file * stride];
+        for (int icol = 0; icol < *w; icol++) {
+            const uint8_t * p = &row[(size_t) icol * bpp / 8];
+            const uint32_t value = bpp == 32 ? get_u32(p) : (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16;
+            pixels[(size_t) irow * *w + icol] = get_channel(value, mask_a) << 24 |
+                                                get_channel(value, mask_r) << 16 |
+                                                get_channel(value, mask_g) << 8 |
+                                                get_channel(value, mask_b);
+        }
+    }
+
+    free(bytes);
+    return pixels;
+}
+
+static void write_bmp (const char * path, const uint32_t * pixels, int w, int h) {
+
+    // write a top-down 32 bit image with a BITMAPV4HEADER, which is how BMP files carry alpha
+    const uint32_t offset_pixels = 14 + 108;
+    const uint32_t npixel_bytes = (uint32_t) w * (uint32_t) h * 4;
+    uint8_t * bytes = calloc(1, offset_pixels + npixel_bytes);
+    if (bytes == nullptr) die("couldn't allocate memory for atlas", path, 0);
+    bytes[0] = 'B';
+    bytes[1] = 'M';
+    put_u32(&bytes[2], offset_pixels + npixel_bytes);
+    put_u32(&bytes[10], offset_pixels);
+    put_u32(&bytes[14], 108);
+    put_u32(&bytes[18], (uint32_t) w);
+    put_u32(&bytes[22], (uint32_t) -h);
+    put_u16(&bytes[26], 1);
+    put_u16(&bytes[28], 32);
+    put_u32(&bytes[30], 3);
+    put_u32(&bytes[34], npixel_bytes);
+    put_u32(&bytes[38], 2835);
+    put_u32(&bytes[42], 2835);
+    put_u32(&bytes[54], 0x00FF0000);
+    put_u32(&bytes[58], 0x0000FF00);
+    put_u32(&bytes[62], 0x000000FF);
+    put_u32(&bytes[66], 0xFF000000);
+    put_u32(&bytes[70], 0x73524742);          // 'sRGB'
+    for (size_t i = 0; i < (size_t) w * (size_t) h; i++) {
+        put_u32(&bytes[offset_pixels + 4 * i], pixels[i]);
+    }
+
+    FILE * ostream = fopen(path, "wb");
+    if (ostream == nullptr) die("couldn't open file for writing", path, 0);
+    if (fwrite(bytes, 1, offset_pixels + npixel_bytes, ostream) != offset_pixels + npixel_bytes) {
+        die("couldn't write file", path, 0);
+    }
+    fclose(ostream);
+    free(bytes);
+}
+
+int main (int argc, char * argv[]) {
+
+    if (argc != 4) {
+        fprintf(stderr, "Usage: atlaspack INPUT OUTPUT_IMAGE OUTPUT_RECTS\n");
+        exit(1);
+    }
+    const char * ipath = argv[1];
+    const char * opath_image = argv[2];
+    const char * opath_rects = argv[3];
+
+    // sheet files are relative to the description's directory
+    const char * slash = strrchr(ipath, '/');
+    const int ndir = slash == nullptr ? 0 : (int) (slash - ipath + 1);
+
+    // read the sheets listed in the description
+    struct sheet sheets[ATLASPACK_NSHEETS_MAX] = {};
+    int nsheets = 0;
+    {
+        FILE * istream = fopen(ipath, "r");
+        if (istream == nullptr) die("couldn't open file for reading", ipath, 0);
+        char line[512];
+        int iline = 0;
+        while (fgets(line, sizeof(line), istream) != nullptr) {
+            iline++;
+            char word[16] = "";
+            if (sscanf(line, "%15s", word) != 1 || word[0] == '#') continue;
+            if (strncmp(word, "sheet", sizeof(word)) != 0) die("expected 'sheet'", ipath, iline);
+            if (nsheets == ATLASPACK_NSHEETS_MAX) die("too many sheets", ipath, iline);
+            struct sheet * sheet = &sheets[nsheets];
+            char name[64] = "";
+            char file[256] = "";
+            char flag[16] = "";
+            const int nfields = sscanf(line, "%*s %63s %255s %15s", name, file, flag);
+            if (nfields < 2) die("expected 'sheet <name> <file> [mirrored]'", ipath, iline);
+            if (nfields == 3 && strncmp(flag, "mirrored", sizeof(flag)) != 0) die("expected 'mirrored'", ipath, iline);
+            if (strlen(name) >= ATLASFILE_NAME_CAP) die("sheet name is too long", ipath, iline);
+            for (int i = 0; i < nsheets; i++) {
+                if (strncmp(sheets[i].name, name, ATLASFILE_NAME_CAP) == 0) die("duplicate sheet name", ipath, iline);
+            }
+            memcpy(sheet->name, name, strlen(name) + 1);
+            sheet->is_mirrored = nfields == 3;
+            char path[1024] = "";
+            snprintf(path, sizeof(path), "%.*s%s", ndir, ipath, file);
+            sheet->pixels = read_bmp(path, &sheet->w, &sheet->h);
+            nsheets++;
+        }
+        fclose(istream);
+    }
+    if (nsheets == 0) die("no sheets", ipath, 0);
+
+    // one placement per sheet, plus one per mirrored copy, tallest first; insertion sort keeps
+    // the order of the description among sheets of equal height
+    struct placement placements[2 * ATLASPACK_NSHEETS_MAX] = {};
+    int nplacements = 0;
+    for (int i = 0; i < nsheets; i++) {
+        for (int m = 0; m < (sheets[i].is_mirrored ? 2 : 1); m++) {
+            const struct placement placement = {
+                .isheet = i,
+                .is_mirrored = m == 1,
+            };
+            int j = nplacements;
+            while (j > 0 && sheets[placements[j - 1].isheet].h < sheets[i].h) {
+                placements[j] = placements[j - 1];
+                j--;
+            }
+            placements[j] = placement;
+            nplacements++;
+        }
+    }
+
+    // grow the width until the packed atlas is no taller than it is wide
+    int w = ATLASPACK_WIDTH_MIN;
+    int h = pack(placements, nplacements, sheets, w);
+    while (h < 0 || h > w) {
+        w *= 2;
+        h = pack(placements, nplacements, sheets, w);
+    }
+
+    // copy the sheets into the atlas, flipping the mirrored copies
+    uint32_t * pixels = calloc((size_t) w * (size_t) h, sizeof(uint32_t));
+    if (pixels == nullptr) die("couldn't allocate memory for atlas", opath_image, 0);
+    for (int i = 0; i < nplacements; i++) {
+        const struct placement * placement = &placements[i];
+        const struct sheet * sheet = &sheets[placement->isheet];
+        for (int irow = 0; irow < sheet->h; irow++) {
+            for (int icol = 0; icol < sheet->w; icol++) {
+                const int icol_src = placement->is_mirrored ? sheet->w - 1 - icol : icol;
+                pixels[(size_t) (placement->y + irow) * w + placement->x + icol] = sheet->pixels[(size_t) irow * sheet->w + icol_src];
+            }
+        }
+    }
+    write_bmp(opath_image, pixels, w, h);
+
+    // write the rect table, in the order of the description
+    const uint32_t size = sizeof(struct atlasfile_header) + nplacements * sizeof(struct atlasfile_rect);
+    uint8_t * block = calloc(1, size);
+    if (block == nullptr) die("couldn't allocate memory for output", opath_rects, 0);
+    const struct atlasfile_header header = {
+        .magic = { ATLASFILE_MAGIC[0], ATLASFILE_MAGIC[1], ATLASFILE_MAGIC[2], ATLASFILE_MAGIC[3] },
+        .version = ATLASFILE_VERSION,
+        .nrects = (uint32_t) nplacements,
+        .size = size,
+    };
+    memcpy(block, &header, sizeof(struct atlasfile_header));
+    struct atlasfile_rect * rects = (struct atlasfile_rect *) &block[sizeof(struct atlasfile_header)];
+    int irect = 0;
+    for (int isheet = 0; isheet < nsheets; isheet++) {
+        for (int i = 0; i < nplacements; i++) {
+            const struct placement * placement = &placements[i];
+            if (placement->isheet != isheet) continue;
+            struct atlasfile_rect * rect = &rects[irect];
+            memcpy(rect->name, sheets[isheet].name, ATLASFILE_NAME_CAP);
+            rect->is_mirrored = placement->is_mirrored;
+            rect->x = (uint32_t) placement->x;
+            rect->y = (uint32_t) placement->y;
+            rect->w = (uint32_t) sheets[isheet].w;
+            rect->h = (uint32_t) sheets[isheet].h;
+            irect++;
+        }
+    }
+    FILE * ostream = fopen(opath_rects, "wb");
+    if (ostream == nullptr) die("couldn't open file for writing", opath_rects, 0);
+    if (fwrite(block, 1, size, ostream) != size) die("couldn't write file", opath_rects, 0);
+    fclose(ostream);
+
+    free(block);
+    free(pixels);
+    for (int i = 0; i < nsheets; i++) {
+        free(sheets[i].pixels);
+    }
+    return 0;
+}
@@ -1,63 +1,58 @@
 #include "animations.h"
+#include "animfile.h"             // struct animfile_header, ANIMFILE_*
+#include "atlas.h"                // struct atlas, atlas_get_rect, atlas_get_texture
+#include "profiler.h"             // MBM_PROFILE_SCOPE
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_filesystem.h"  // SDL_GetBasePath
+#include "SDL3/SDL_iostream.h"    // SDL_IOStream, SDL_IOFromFile, SDL_GetIOSize, SDL_ReadIO, SDL_CloseIO
 #include "SDL3/SDL_log.h"         // SDL_LogCritical
 #include "SDL3/SDL_rect.h"        // SDL_FRect
-#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_CreateTextureFromSurface, SDL_DestroyTexture
-#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_free, SDL_calloc
-#include "SDL3/SDL_surface.h"     // SDL_Surface, SDL_LoadBMP, SDL_DestroySurface
-#include <stdint.h>               // uint8_t, int64_t
+#include "SDL3/SDL_render.h"      // SDL_Texture
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_free, SDL_calloc, SDL_malloc, SDL_aligned_alloc, SDL_aligned_free, SDL_memcmp
+#include <stdint.h>               // uint8_t, int32_t, int64_t, uint32_t
 #include <stdlib.h>               // exit
 
-// declare properties of `struct animations`
+// the arrays in the data block are used as they are laid out in the file
+static_assert(sizeof(int) == sizeof(int32_t), "int should be 32 bits wide");
+static_assert(sizeof(SDL_FRect) == 4 * sizeof(float), "SDL_FRect should consist of 4 floats");
+
+// declare properties of `struct animations`; all arrays live in one contiguous, cache-aligned
+// block that is read from file as is, with the frames of all animations packed back to back.
+// The frame sources in the file are relative to the sprite sheet, and are moved to the sheet's
+// place in the atlas on load.
 struct animations {
-    int64_t * durations;
-    int64_t ** frame_durations_acc;
-    SDL_FRect ** frame_srcs;
-    int nframes_cap;
+    void * block;
+    int64_t * durations;                      // per animation
+    int * frame_offsets;                      // per animation, index of its first frame
+    int64_t * frame_ends;                     // per frame, accumulated duration within its animation
+    SDL_FRect * frame_srcs;                   // per frame
+    SDL_FRect * frame_srcs_mirrored;          // per frame, in the sheet's horizontally flipped copy
     int nanims;
-    int nanims_cap;
-    int * nframes;
-    SDL_Texture * texture;
+    int * nframes;                            // per animation
+    SDL_Texture * texture;                    // the atlas' texture
 };
 
 // forward declarations of functions defined below
-static SDL_Texture * load_texture (const char * relpath, SDL_Renderer * renderer);
+static int find_frame (const struct animations * self, int ianim, int64_t progress);
+static uint8_t * load_block (const char * relpath, int nanims_min, struct animfile_header * header);
 
 void animations_delete (struct animations ** self) {
 
-    SDL_DestroyTexture((*self)->texture);
     (*self)->texture = nullptr;
 
-    SDL_free((*self)->nframes);
-    (*self)->nframes = nullptr;
-
-    SDL_free((*self)->frame_srcs[0]);
-    (*self)->frame_srcs[0] = nullptr;
-
-    SDL_free((*self)->frame_srcs);
-    (*self)->frame_srcs = nullptr;
-
-    SDL_free((*self)->frame_durations_acc[0]);
-    (*self)->frame_durations_acc[0] = nullptr;
-
-    SDL_free((*self)->frame_durations_acc);
-    (*self)->frame_durations_acc = nullptr;
+    SDL_free((*self)->frame_srcs_mirrored);
+    (*self)->frame_srcs_mirrored = nullptr;
 
-    SDL_free((*self)->durations);
-    (*self)->durations = nullptr;
+    SDL_aligned_free((*self)->block);
+    (*self)->block = nullptr;
 
     SDL_free(*self);
     *self = nullptr;
 }
 
-struct animations * animations_new (int nanims_cap, int nframes_cap, const char * relpath, SDL_Renderer * renderer) {
+struct animations * animations_new (const char * relpath_anims, int nanims_min, const struct atlas * atlas, const char * sheet) {
 
     struct animations * animations = nullptr;
-    int64_t * durations = nullptr;
-    SDL_FRect ** frame_srcs = nullptr;
-    int64_t ** frame_durations_acc = nullptr;
-    int * nframes = nullptr;
 
     // allocate dynamic memory for holding the struct animations (`self`)
     {
@@ -70,127 +65,58 @@ struct animations * animations_new (int nanims_cap, int nframes_cap, const char
         }
     }
 
-    // allocate dynamic memory for holding the 1d array with the animation durations (`.durations`)
-    {
-        durations = SDL_calloc(nanims_cap, sizeof(int64_t));
-        if (durations == nullptr) {
-            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create dynamic memory for storing animation durations, aborting; %s\n",
-                            SDL_GetError());
-            exit(1);
-        }
-    }
+    // read the data block, which is laid out the way it's used; the caller indexes the animations
+    // by its own enumeration, so the file has to hold at least `nanims_min` of them
+    struct animfile_header header = {};
+    uint8_t * block = load_block(relpath_anims, nanims_min, &header);
 
-    // allocate dynamic memory for holding the 2d array with the frame rectangles (`.frame_srcs`)
-    {
-        SDL_FRect * frame_srcs_contig = SDL_calloc(nanims_cap * nframes_cap, sizeof(SDL_FRect));
-        if (frame_srcs_contig == nullptr) {
-            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create contiguous dynamic memory for storing frame rects, aborting; %s\n",
-                            SDL_GetError());
-            exit(1);
-        }
-        frame_srcs = SDL_calloc(nanims_cap, sizeof(SDL_FRect *));
-        if (frame_srcs == nullptr) {
-            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create dynamic memory for storing pointers to frame rects, aborting; %s\n",
-                            SDL_GetError());
-            exit(1);
-        }
-        for (int i = 0; i < nanims_cap; ++i) {
-            frame_srcs[i] = &frame_srcs_contig[i * nframes_cap];
-        }
-        // don't free `frame_srcs_contig` yet, since it's used via `.frame_srcs[0]`
-    }
+    // assemble the struct animations / self
+    *animations = (struct animations) {
+        .block = block,
+        .durations = (int64_t *) &block[header.offset_durations],
+        .frame_offsets = (int *) &block[header.offset_frame_offsets],
+        .frame_ends = (int64_t *) &block[header.offset_frame_ends],
+        .frame_srcs = (SDL_FRect *) &block[header.offset_frame_srcs],
+        .nanims = (int) header.nanims,
+        .nframes = (int *) &block[header.offset_nframes],
+        .texture = atlas_get_texture(atlas),
+    };
 
-    // allocate dynamic memory for holding the 2d array with the accumulated frame durations (`.frame_durations_acc`)
+    // move the frame sources into the atlas; a mirrored frame starts as far from the right edge
+    // of the flipped copy as the original does from the left edge of the sheet
     {
-        int64_t * frame_durations_acc_contig = SDL_calloc(nanims_cap * nframes_cap, sizeof(int64_t));
-        if (frame_durations_acc_contig == nullptr) {
-            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create contiguous dynamic memory for storing accumated frame durations, aborting; %s\n",
-                            SDL_GetError());
-            exit(1);
-        }
-        frame_durations_acc = SDL_calloc(nanims_cap, sizeof(int64_t *));
-        if (frame_durations_acc == nullptr) {
+        const SDL_FRect rect = atlas_get_rect(atlas, sheet, false);
+        const SDL_FRect rect_mirrored = atlas_get_rect(atlas, sheet, true);
+        animations->frame_srcs_mirrored = SDL_malloc(header.nframes * sizeof(SDL_FRect));
+        if (animations->frame_srcs_mirrored == nullptr) {
             SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create dynamic memory for storing pointers to accumulated frame durations, aborting; %s\n",
+                            "Couldn't create dynamic memory for storing mirrored frames, aborting; %s\n",
                             SDL_GetError());
             exit(1);
         }
-        for (int i = 0; i < nanims_cap; ++i) {
-            frame_durations_acc[i] = &frame_durations_acc_contig[i * nframes_cap];
+        for (uint32_t i = 0; i < header.nframes; i++) {
+            const SDL_FRect src = animations->frame_srcs[i];
+            animations->frame_srcs[i].x = rect.x + src.x;
+            animations->frame_srcs[i].y = rect.y + src.y;
+            animations->frame_srcs_mirrored[i] = (SDL_FRect) {
+                .h = src.h,
+                .w = src.w,
+                .x = rect_mirrored.x + rect_mirrored.w - src.x - src.w,
+                .y = rect_mirrored.y + src.y,
+            };
         }
-        // don't free `frame_durations_acc_contig` yet, since it's used via `.frame_durations_acc[0]`
     }
 
-    // allocate dynamic memory for holding the 1d array with the number of frames (`.nframes`)
-    nframes = SDL_calloc(nanims_cap, sizeof(int));
-    if (nframes == nullptr) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Couldn't create dynamic memory for storing nframes, aborting; %s\n",
-                        SDL_GetError());
-        exit(1);
-    }
-
-    // assemble the struct animations / self
-    *animations = (struct animations) {
-        .durations = durations,
-        .frame_durations_acc = frame_durations_acc,
-        .frame_srcs = frame_srcs,
-        .nanims = 0,
-        .nanims_cap = nanims_cap,
-        .nframes = nframes,
-        .nframes_cap = nframes_cap,
-        .texture = load_texture(relpath, renderer),
-    };
-
     return animations;
 }
 
-void animations_append_anim (struct animations * self) {
-
-    // find the index of the next animation
-    int ianim = self->nanims;
-    if (ianim >= self->nanims_cap) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Can't append animation past the allocated space, aborting\n");
-        exit(1);
-    }
-
-    // increment the number of animations
-    self->nanims++;
-}
-
-void animations_append_frame (struct animations * self, int64_t duration, SDL_FRect src) {
-
-    // find the index of the next frame in the last animation
-    const int ianim = self->nanims - 1;
-    int iframe = self->nframes[ianim];
-    if (iframe >= self->nframes_cap) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Can't append frame past the allocated space, aborting\n");
-        exit(1);
-    }
-
-    // add the frame, update durations
-    self->frame_srcs[ianim][iframe] = src;
-    if (iframe == 0) {
-        self->frame_durations_acc[ianim][iframe] = duration;
-    } else {
-        self->frame_durations_acc[ianim][iframe] = self->frame_durations_acc[ianim][iframe-1] + duration;
-    }
-    self->durations[ianim] += duration;
-    self->nframes[ianim]++;
-}
-
 int64_t animations_get_animation_duration (struct animations * self, int ianim) {
     return self->durations[ianim];
 }
 
-SDL_FRect animations_get_frame (const struct animations * self, int ianim, int iframe) {
-    return self->frame_srcs[ianim][iframe];
+SDL_FRect animations_get_frame (const struct animations * self, int ianim, int iframe, bool is_mirrored) {
+    const SDL_FRect * srcs = is_mirrored ? self->frame_srcs_mirrored : self->frame_srcs;
+    return srcs[self->frame_offsets[ianim] + iframe];
 }
 
 SDL_Texture * animations_get_texture (const struct animations * self) {
@@ -198,54 +124,135 @@ SDL_Texture * animations_get_texture (const struct animations * self) {
 }
 
 void animations_update (const struct animations * self, int ianim, int64_t anim_phase_shift, int64_t tnow, int64_t * t_frame_expires, int * iframe) {
+    MBM_PROFILE_SCOPE("animations_update");
 
-    // calculate time since 0, after applying phase shift
-    const int64_t tshifted = tnow - anim_phase_shift;
+    // calculate how many µs we have progressed into the current wavelength / animation duration,
+    // after applying the phase shift
+    const int64_t progress = (tnow - anim_phase_shift) % self->durations[ianim];
 
-    // calculate how many µs we have progressed into the current wavelength / animation duration
-    const int64_t progress = tshifted % self->durations[ianim];
+    // find the frame and calculate when it expires
+    *iframe = find_frame(self, ianim, progress);
+    *t_frame_expires = tnow - progress + self->frame_ends[self->frame_offsets[ianim] + *iframe];
+}
 
-    // keep incrementing *frame until the frame's rhs limit exceeds `tprogress` (or we run out of frames)
-    *iframe = 0;
-    while (self->frame_durations_acc[ianim][*iframe] < progress && *iframe < self->nframes[ianim] - 1) {
-        (*iframe)++;
+void animations_update_batch (const struct animations * self, int n, const int * ianims, const int64_t * anim_phase_shifts, int64_t tnow, int64_t * t_frame_expires, int * iframes) {
+    MBM_PROFILE_SCOPE("animations_update_batch");
+
+    // like animations_update(), for `n` animated objects at once; objects whose current frame
+    // hasn't expired yet are skipped
+    for (int i = 0; i < n; i++) {
+        if (tnow <= t_frame_expires[i]) continue;
+        const int ianim = ianims[i];
+        const int64_t progress = (tnow - anim_phase_shifts[i]) % self->durations[ianim];
+        iframes[i] = find_frame(self, ianim, progress);
+        t_frame_expires[i] = tnow - progress + self->frame_ends[self->frame_offsets[ianim] + iframes[i]];
     }
+}
 
-    // update `*t_frame_expires` with the newly identified accumulated duration of `*iframe`
-    *t_frame_expires = tnow - progress + self->frame_durations_acc[ianim][*iframe];
+static int find_frame (const struct animations * self, int ianim, int64_t progress) {
+
+    // binary search for the first frame whose end lies at or beyond `progress`, falling back to
+    // the last frame
+    const int64_t * ends = &self->frame_ends[self->frame_offsets[ianim]];
+    int lo = 0;
+    int hi = self->nframes[ianim] - 1;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (ends[mid] < progress) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
 }
 
-static SDL_Texture * load_texture (const char * relpath, SDL_Renderer * renderer) {
+static uint8_t * load_block (const char * relpath, int nanims_min, struct animfile_header * header) {
 
-    // create surface given relative path
+    // read the whole file into a cache-aligned block with a single read
     char * path = nullptr;
     SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
-    SDL_Surface * surface = SDL_LoadBMP(path);
-    if (surface == nullptr) {
+    SDL_IOStream * stream = SDL_IOFromFile(path, "rb");
+    if (stream == nullptr) {
         SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Couldn't load surface for duck, aborting; %s\n",
-                        SDL_GetError());
+                        "Couldn't open animations file '%s', aborting; %s\n",
+                        path, SDL_GetError());
+        SDL_free(path);
         exit(1);
     }
-
-    // create texture from surface
-    SDL_Texture * texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr) {
+    const Sint64 size = SDL_GetIOSize(stream);
+    if (size < (Sint64) sizeof(struct animfile_header)) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Animations file '%s' is too small, aborting.\n", path);
+        SDL_free(path);
+        exit(1);
+    }
+    uint8_t * block = SDL_aligned_alloc(ANIMFILE_ALIGNMENT, (size_t) size);
+    if (block == nullptr) {
         SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Couldn't create texture for duck, aborting; %s\n",
+                        "Couldn't create dynamic memory for storing animation data, aborting; %s\n",
                         SDL_GetError());
+        SDL_free(path);
+        exit(1);
+    }
+    if (SDL_ReadIO(stream, block, (size_t) size) != (size_t) size) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't read animations file '%s', aborting; %s\n",
+                        path, SDL_GetError());
+        SDL_free(path);
+        exit(1);
+    }
+    SDL_CloseIO(stream);
+
+    // check the header before trusting the offsets in it
+    SDL_memcpy(header, block, sizeof(struct animfile_header));
+    const uint32_t nanims = header->nanims;
+    const uint32_t nframes = header->nframes;
+    const bool is_valid = SDL_memcmp(header->magic, ANIMFILE_MAGIC, 4) == 0 &&
+                          header->version == ANIMFILE_VERSION &&
+                          header->size == (uint32_t) size &&
+                          header->offset_durations + nanims * sizeof(int64_t) <= header->size &&
+                          header->offset_frame_offsets + nanims * sizeof(int32_t) <= header->size &&
+                          header->offset_nframes + nanims * sizeof(int32_t) <= header->size &&
+                          header->offset_frame_ends + nframes * sizeof(int64_t) <= header->size &&
+                          header->offset_frame_srcs + nframes * sizeof(SDL_FRect) <= header->size &&
+                          (header->offset_durations | header->offset_frame_offsets | header->offset_nframes |
+                           header->offset_frame_ends | header->offset_frame_srcs) % ANIMFILE_ALIGNMENT == 0;
+    if (!is_valid) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Animations file '%s' is invalid or was built for another version, aborting.\n", path);
+        SDL_free(path);
+        exit(1);
+    }
+    if (nanims < (uint32_t) nanims_min) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Animations file '%s' holds %u animations where %d are needed, aborting.\n",
+                        path, nanims, nanims_min);
+        SDL_free(path);
         exit(1);
     }
 
-    // set texture scale mode
-    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+    // check each animation before trusting it: its frames have to lie within the frame arrays,
+    // since finding a frame indexes them, and its duration has to be positive, since the
+    // progress into an animation is taken modulo its duration
+    const int64_t * durations = (const int64_t *) &block[header->offset_durations];
+    const int32_t * frame_offsets = (const int32_t *) &block[header->offset_frame_offsets];
+    const int32_t * nframes_per_anim = (const int32_t *) &block[header->offset_nframes];
+    for (uint32_t i = 0; i < nanims; i++) {
+        const bool is_anim_valid = durations[i] > 0 &&
+                                   frame_offsets[i] >= 0 &&
+                                   nframes_per_anim[i] >= 1 &&
+                                   (int64_t) frame_offsets[i] + nframes_per_anim[i] <= (int64_t) nframes;
+        if (!is_anim_valid) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Animation %u in animations file '%s' is invalid, aborting.\n", i, path);
+            SDL_free(path);
+            exit(1);
+        }
+    }
 
-    // free dynamically allocated memory used by surface and by path
-    SDL_DestroySurface(surface);
-    surface = nullptr;
     SDL_free(path);
     path = nullptr;
 
-    // return texture
-    return texture;
+    return block;
 }
@@ -0,0 +1,26 @@
+#ifndef MBM_ANIMFILE_H_INCLUDED
+#define MBM_ANIMFILE_H_INCLUDED
+#include <stdint.h>               // uint32_t
+
+// Layout of the binary animation files that `animpack` writes and that animations_new() reads. A
+// file is an image of the animations' data block: this header, followed by the arrays at the
+// offsets listed in it, each aligned to ANIMFILE_ALIGNMENT bytes. Numbers are stored in the byte
+// order of the machine that built the file.
+#define ANIMFILE_ALIGNMENT 64
+#define ANIMFILE_MAGIC "MBMA"
+#define ANIMFILE_VERSION 1
+
+struct animfile_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t nanims;
+    uint32_t nframes;                         // all animations combined
+    uint32_t offset_durations;                // int64_t[nanims]
+    uint32_t offset_frame_offsets;            // int32_t[nanims]
+    uint32_t offset_nframes;                  // int32_t[nanims]
+    uint32_t offset_frame_ends;               // int64_t[nframes]
+    uint32_t offset_frame_srcs;               // float[nframes][4], as x, y, w, h
+    uint32_t size;                            // bytes, including the header
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "atlas.h"
+#include "atlasfile.h"            // struct atlasfile_header, struct atlasfile_rect, ATLASFILE_*
+#include "resources.h"            // struct resources, resources_acquire_texture, resources_release_texture
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_filesystem.h"  // SDL_GetBasePath
+#include "SDL3/SDL_iostream.h"    // SDL_LoadFile
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_rect.h"        // SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_free, SDL_memcmp, SDL_strncmp
+#include <stdlib.h>               // exit
+
+// declare properties of `struct atlas`
+struct atlas {
+    int nrects;
+    struct atlasfile_rect * rects;            // points into `table`
+    struct resources * resources;
+    void * table;                             // contents of the rect table file
+    SDL_Texture * texture;                    // shared
+};
+
+// define pointer to singleton instance of `struct atlas`
+static struct atlas * singleton = nullptr;
+
+void atlas_delete (struct atlas ** self) {
+    resources_release_texture((*self)->resources, (*self)->texture);
+    (*self)->texture = nullptr;
+    SDL_free((*self)->table);
+    (*self)->table = nullptr;
+    (*self)->rects = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+    singleton = nullptr;
+}
+
+SDL_FRect atlas_get_rect (const struct atlas * self, const char * name, bool is_mirrored) {
+    for (int i = 0; i < self->nrects; i++) {
+        const struct atlasfile_rect * rect = &self->rects[i];
+        if ((rect->is_mirrored != 0) != is_mirrored) continue;
+        if (SDL_strncmp(rect->name, name, ATLASFILE_NAME_CAP) != 0) continue;
+        return (SDL_FRect) {
+            .h = (float) rect->h,
+            .w = (float) rect->w,
+            .x = (float) rect->x,
+            .y = (float) rect->y,
+        };
+    }
+    SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                    "Sprite sheet '%s'%s isn't in the atlas, aborting.\n",
+                    name, is_mirrored ? " (mirrored)" : "");
+    exit(1);
+}
+
+SDL_Texture * atlas_get_texture (const struct atlas * self) {
+    return self->texture;
+}
+
+void atlas_init (struct atlas * self, SDL_Renderer * renderer, struct resources * resources) {
+
+    // the rect table is small, so read it in one go
+    char * path = nullptr;
+    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), "../share/mbm/assets/images/atlas.rects");
+    size_t size = 0;
+    void * table = SDL_LoadFile(path, &size);
+    if (table == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't read atlas rect table, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+
+    // check the header before trusting the number of rects in it
+    const struct atlasfile_header * header = (const struct atlasfile_header *) table;
+    const bool is_valid = size >= sizeof(struct atlasfile_header) &&
+                          SDL_memcmp(header->magic, ATLASFILE_MAGIC, 4) == 0 &&
+                          header->version == ATLASFILE_VERSION &&
+                          header->size == size &&
+                          sizeof(struct atlasfile_header) + header->nrects * sizeof(struct atlasfile_rect) <= size;
+    if (!is_valid) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Atlas rect table '%s' is invalid or was built for another version, aborting.\n", path);
+        exit(1);
+    }
+    SDL_free(path);
+    path = nullptr;
+
+    *self = (struct atlas) {
+        .nrects = (int) header->nrects,
+        .rects = (struct atlasfile_rect *) ((char *) table + sizeof(struct atlasfile_header)),
+        .resources = resources,
+        .table = table,
+        .texture = resources_acquire_texture(resources, "../share/mbm/assets/images/atlas.bmp", renderer),
+    };
+}
+
+struct atlas * atlas_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct atlas *) SDL_calloc(1, sizeof(struct atlas));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct atlas, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
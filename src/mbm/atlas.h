@@ -0,0 +1,18 @@
+#ifndef MBM_ATLAS_H_INCLUDED
+#define MBM_ATLAS_H_INCLUDED
+#include "mbm/abi.h"
+#include "resources.h"            // struct resources
+#include "SDL3/SDL_rect.h"        // SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture
+
+// `struct atlas` is an opaque data structure;
+// only the implementation has access to its layout
+struct atlas;
+
+MBM_NO_ABI void atlas_delete (struct atlas ** self);
+MBM_NO_ABI SDL_FRect atlas_get_rect (const struct atlas * self, const char * name, bool is_mirrored);
+MBM_NO_ABI SDL_Texture * atlas_get_texture (const struct atlas * self);
+MBM_NO_ABI void atlas_init (struct atlas * self, SDL_Renderer * renderer, struct resources * resources);
+MBM_NO_ABI struct atlas * atlas_new (void);
+
+#endif
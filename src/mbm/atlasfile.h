@@ -0,0 +1,29 @@
+#ifndef MBM_ATLASFILE_H_INCLUDED
+#define MBM_ATLASFILE_H_INCLUDED
+#include <stdint.h>               // uint32_t
+
+// Layout of the binary rect tables that `atlaspack` writes next to the atlas image, and that
+// atlas_init() reads. A file is this header, directly followed by `nrects` rects, one per sprite
+// sheet in the atlas plus one per mirrored copy. Numbers are stored in the byte order of the
+// machine that built the file.
+#define ATLASFILE_MAGIC "MBMR"
+#define ATLASFILE_NAME_CAP 16
+#define ATLASFILE_VERSION 1
+
+struct atlasfile_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t nrects;
+    uint32_t size;                            // bytes, including the header
+};
+
+struct atlasfile_rect {
+    char name[ATLASFILE_NAME_CAP];            // name of the sprite sheet, zero-terminated
+    uint32_t is_mirrored;                     // whether this is the horizontally flipped copy
+    uint32_t x;                               // pixels, in the atlas
+    uint32_t y;                               // pixels, in the atlas
+    uint32_t w;                               // pixels
+    uint32_t h;                               // pixels
+};
+
+#endif
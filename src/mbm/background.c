@@ -1,20 +1,145 @@
 #include "mbm/background.h"       // struct background and associated functions
+#include "mbm/dims.h"             // struct dims
+#include "camera.h"               // struct camera, camera_get_view
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_log.h"         // SDL_LogCritical
-#include "SDL3/SDL_pixels.h"      // SDL_Color
-#include "SDL3/SDL_render.h"      // SDL_Renderer
-#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc
+#include "SDL3/SDL_pixels.h"      // SDL_Color, SDL_PIXELFORMAT_RGBA32
+#include "SDL3/SDL_rect.h"        // SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_CreateTextureFromSurface, SDL_RenderTexture
+#include "SDL3/SDL_stdinc.h"      // SDL_calloc, SDL_floorf, SDL_free, SDL_sinf, SDL_PI_F
+#include "SDL3/SDL_surface.h"     // SDL_Surface, SDL_CreateSurface, SDL_DestroySurface
+#include <stdint.h>               // uint8_t
 #include <stdlib.h>               // exit
 
+// the sky, far hills and near hills, back to front
+#define BACKGROUND_NLAYERS 3
+
+// a sum of sines whose frequencies are whole numbers of periods per texture width, such that a
+// ridge line ends at the height that it starts at, and its texture wraps around without a seam
+#define BACKGROUND_NHARMONICS 3
+
+struct harmonic {
+    float amplitude;                          // fraction of the view's height
+    int nperiods;                             // per texture width
+    float phase;                              // radians
+};
+
+// describes how to rasterize a layer, once
+struct layer_spec {
+    SDL_Color bottom;                         // color at the bottom of the view
+    float factor;                             // fraction of the camera's movement that the layer follows
+    struct harmonic harmonics[BACKGROUND_NHARMONICS];
+    float horizon;                            // mean height of the ridge line, as a fraction of the view's height
+    SDL_Color top;                            // color at the ridge line, or at the top of the view for the sky
+};
+
+struct layer {
+    float factor;
+    SDL_Texture * texture;                    // as wide as the view, wraps around horizontally
+    float x;                                  // pixels, where the texture's left edge is in the view, in (-w, 0]
+};
+
 // declare properties of `struct background`
 struct background {
-    SDL_Color color;
+    SDL_Color color;                          // what the frame is cleared to, including the letterboxing
+    int h;                                    // pixels
+    struct layer layers[BACKGROUND_NLAYERS];
+    int w;                                    // pixels
+};
+
+// the first layer has no harmonics and doesn't move; it's the sky
+static const struct layer_spec specs[BACKGROUND_NLAYERS] = {
+    {
+        .bottom = { .r = 126, .g = 192, .b = 220, .a = SDL_ALPHA_OPAQUE },
+        .factor = 0.0f,
+        .harmonics = {},
+        .horizon = 1.0f,
+        .top = { .r = 12, .g = 121, .b = 168, .a = SDL_ALPHA_OPAQUE },
+    },
+    {
+        .bottom = { .r = 86, .g = 124, .b = 150, .a = SDL_ALPHA_OPAQUE },
+        .factor = 0.2f,
+        .harmonics = {
+            { .amplitude = 0.10f, .nperiods = 1, .phase = 0.3f },
+            { .amplitude = 0.06f, .nperiods = 3, .phase = 1.9f },
+            { .amplitude = 0.02f, .nperiods = 7, .phase = 4.1f },
+        },
+        .horizon = 0.45f,
+        .top = { .r = 64, .g = 102, .b = 133, .a = SDL_ALPHA_OPAQUE },
+    },
+    {
+        .bottom = { .r = 36, .g = 92, .b = 70, .a = SDL_ALPHA_OPAQUE },
+        .factor = 0.5f,
+        .harmonics = {
+            { .amplitude = 0.06f, .nperiods = 2, .phase = 2.5f },
+            { .amplitude = 0.04f, .nperiods = 5, .phase = 0.7f },
+            { .amplitude = 0.01f, .nperiods = 11, .phase = 3.3f },
+        },
+        .horizon = 0.65f,
+        .top = { .r = 58, .g = 124, .b = 84, .a = SDL_ALPHA_OPAQUE },
+    },
 };
 
 // define pointer to singleton instance of `struct background`
 static struct background * singleton = nullptr;
 
+// forward declaration of static functions
+static uint8_t mix (uint8_t a, uint8_t b, float t);
+static SDL_Texture * rasterize (const struct layer_spec * spec, SDL_Renderer * renderer, int w, int h);
+
+static uint8_t mix (uint8_t a, uint8_t b, float t) {
+    return (uint8_t) ((1.0f - t) * a + t * b + 0.5f);
+}
+
+static SDL_Texture * rasterize (const struct layer_spec * spec, SDL_Renderer * renderer, int w, int h) {
+    SDL_Surface * surface = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_RGBA32);
+    if (surface == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't create surface for background layer, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+
+    // fill each column from the ridge line down, with a vertical gradient; above the ridge line,
+    // the layer is transparent, such that the layers behind it show
+    for (int x = 0; x < w; x++) {
+        float ridge = spec->horizon;
+        for (int k = 0; k < BACKGROUND_NHARMONICS; k++) {
+            const struct harmonic * harmonic = &spec->harmonics[k];
+            ridge += harmonic->amplitude * SDL_sinf(2.0f * SDL_PI_F * harmonic->nperiods * x / w + harmonic->phase);
+        }
+        const int y_ridge = spec->factor == 0.0f ? 0 : (int) SDL_floorf(ridge * h);
+        for (int y = 0; y < h; y++) {
+            uint8_t * pixel = &((uint8_t *) surface->pixels)[y * surface->pitch + 4 * x];
+            if (y < y_ridge) {
+                pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                continue;
+            }
+            const float t = (float) (y - y_ridge) / (float) (h - y_ridge);
+            pixel[0] = mix(spec->top.r, spec->bottom.r, t);
+            pixel[1] = mix(spec->top.g, spec->bottom.g, t);
+            pixel[2] = mix(spec->top.b, spec->bottom.b, t);
+            pixel[3] = SDL_ALPHA_OPAQUE;
+        }
+    }
+
+    SDL_Texture * texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't create texture for background layer, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+    SDL_DestroySurface(surface);
+    return texture;
+}
+
 void background_delete (struct background ** self) {
+    for (int i = 0; i < BACKGROUND_NLAYERS; i++) {
+        SDL_DestroyTexture((*self)->layers[i].texture);
+        (*self)->layers[i].texture = nullptr;
+    }
     SDL_free(*self);
     *self = nullptr;
 }
@@ -22,9 +147,26 @@ void background_delete (struct background ** self) {
 void background_draw (const struct background * self, SDL_Renderer * renderer) {
     SDL_SetRenderDrawColor(renderer, self->color.r, self->color.g, self->color.b, self->color.a);
     SDL_RenderClear(renderer);
+
+    // each layer is as wide as the view, so it takes one blit when it's aligned with the view,
+    // and two when it's wrapped around
+    for (int i = 0; i < BACKGROUND_NLAYERS; i++) {
+        const struct layer * layer = &self->layers[i];
+        SDL_FRect dst = (SDL_FRect) {
+            .h = (float) self->h,
+            .w = (float) self->w,
+            .x = layer->x,
+            .y = 0.0f,
+        };
+        SDL_RenderTexture(renderer, layer->texture, nullptr, &dst);
+        if (layer->x < 0.0f) {
+            dst.x += (float) self->w;
+            SDL_RenderTexture(renderer, layer->texture, nullptr, &dst);
+        }
+    }
 }
 
-void background_init (struct background * self) {
+void background_init (struct background * self, SDL_Renderer * renderer, const struct dims * dims) {
     *self = (struct background) {
         .color = (SDL_Color) {
             .r = 12,
@@ -32,7 +174,18 @@ void background_init (struct background * self) {
             .b = 168,
             .a = SDL_ALPHA_OPAQUE,
         },
+        .h = dims->view.h,
+        .w = dims->view.w,
     };
+
+    // rasterize the layers up front; from here on, scrolling only moves them
+    for (int i = 0; i < BACKGROUND_NLAYERS; i++) {
+        self->layers[i] = (struct layer) {
+            .factor = specs[i].factor,
+            .texture = rasterize(&specs[i], renderer, self->w, self->h),
+            .x = 0.0f,
+        };
+    }
 }
 
 struct background * background_new (void) {
@@ -50,7 +203,15 @@ struct background * background_new (void) {
     return singleton;
 }
 
-void background_update (struct background * self, const struct timings * timings) {
-    (void) self;
-    (void) timings;
+void background_update (struct background * self, const struct camera * camera) {
+    // layers further back follow a smaller fraction of the camera's horizontal movement, which
+    // makes them appear further away; the layers are as tall as the view, so they don't follow
+    // vertical movement
+    const SDL_FRect view = camera_get_view(camera);
+    const float w = (float) self->w;
+    for (int i = 0; i < BACKGROUND_NLAYERS; i++) {
+        struct layer * layer = &self->layers[i];
+        const float x = view.x * layer->factor;
+        layer->x = -(x - SDL_floorf(x / w) * w);
+    }
 }
@@ -0,0 +1,253 @@
+#include "bvh.h"
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_stdinc.h"      // SDL_calloc, SDL_free, SDL_max, SDL_min, SDL_qsort
+#include <float.h>                // FLT_MAX
+#include <stdlib.h>               // exit
+
+// leaves hold up to this many rectangles; testing a few rectangles is cheaper than descending
+// another level
+#define BVH_NLEAF_MAX 4
+
+// upper limit on the depth of the hierarchy; splitting at the median keeps it balanced, so it
+// takes about log2(nrects / BVH_NLEAF_MAX) levels
+#define BVH_DEPTH_MAX 64
+
+// a rectangle while building, with its center as the key to split on
+struct item {
+    SDL_FPoint center;
+    SDL_FRect rect;
+};
+
+struct node {
+    SDL_FRect bounds;
+    int ifirst;                               // leaf: first rectangle in `rects`
+    int iright;                               // interior: the right child; the left child follows the node
+    int n;                                    // leaf: number of rectangles; 0 for an interior node
+};
+
+// declare properties of `struct bvh`
+struct bvh {
+    int nnodes;
+    struct node * nodes;                      // depth first, root first
+    int nrects;
+    SDL_FRect * rects;                        // in the order of the leaves
+};
+
+// forward declaration of static functions
+static void * allocate (size_t n, size_t size);
+static int build (struct bvh * self, struct item * items, int ifirst, int n);
+static int compare_x (const void * a, const void * b);
+static int compare_y (const void * a, const void * b);
+static bool intersect_ray (SDL_FRect rect, SDL_FPoint origin, SDL_FPoint direction, float tmax, float * t);
+static bool is_overlapping (SDL_FRect a, SDL_FRect b);
+static SDL_FRect unite (SDL_FRect a, SDL_FRect b);
+
+static void * allocate (size_t n, size_t size) {
+    void * mem = SDL_calloc(n, size);
+    if (mem == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Error allocating dynamic memory for bounding volume hierarchy, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return mem;
+}
+
+static int build (struct bvh * self, struct item * items, int ifirst, int n) {
+    const int inode = self->nnodes;
+    self->nnodes++;
+    SDL_FRect bounds = items[ifirst].rect;
+    float cx0 = items[ifirst].center.x;
+    float cx1 = cx0;
+    float cy0 = items[ifirst].center.y;
+    float cy1 = cy0;
+    for (int i = ifirst + 1; i < ifirst + n; i++) {
+        bounds = unite(bounds, items[i].rect);
+        cx0 = SDL_min(cx0, items[i].center.x);
+        cx1 = SDL_max(cx1, items[i].center.x);
+        cy0 = SDL_min(cy0, items[i].center.y);
+        cy1 = SDL_max(cy1, items[i].center.y);
+    }
+    if (n <= BVH_NLEAF_MAX) {
+        for (int i = ifirst; i < ifirst + n; i++) {
+            self->rects[i] = items[i].rect;
+        }
+        self->nodes[inode] = (struct node) {
+            .bounds = bounds,
+            .ifirst = ifirst,
+            .iright = 0,
+            .n = n,
+        };
+        return inode;
+    }
+
+    // split at the median of the centers, along the axis that they're spread out most over
+    const bool is_wide = cx1 - cx0 >= cy1 - cy0;
+    SDL_qsort(&items[ifirst], (size_t) n, sizeof(struct item), is_wide ? compare_x : compare_y);
+    const int nleft = n / 2;
+    build(self, items, ifirst, nleft);
+    const int iright = build(self, items, ifirst + nleft, n - nleft);
+    self->nodes[inode] = (struct node) {
+        .bounds = bounds,
+        .ifirst = 0,
+        .iright = iright,
+        .n = 0,
+    };
+    return inode;
+}
+
+static int compare_x (const void * a, const void * b) {
+    const float xa = ((const struct item *) a)->center.x;
+    const float xb = ((const struct item *) b)->center.x;
+    return xa < xb ? -1 : xa > xb;
+}
+
+static int compare_y (const void * a, const void * b) {
+    const float ya = ((const struct item *) a)->center.y;
+    const float yb = ((const struct item *) b)->center.y;
+    return ya < yb ? -1 : ya > yb;
+}
+
+static bool intersect_ray (SDL_FRect rect, SDL_FPoint origin, SDL_FPoint direction, float tmax, float * t) {
+    // clip the ray's parameter range against the rectangle's slabs, one axis at a time; a ray
+    // that starts inside the rectangle hits it at t = 0
+    float tenter = 0.0f;
+    float texit = tmax;
+    const float o[2] = { origin.x, origin.y };
+    const float d[2] = { direction.x, direction.y };
+    const float lo[2] = { rect.x, rect.y };
+    const float hi[2] = { rect.x + rect.w, rect.y + rect.h };
+    for (int axis = 0; axis < 2; axis++) {
+        if (d[axis] == 0.0f) {
+            // parallel to the slab, so either always or never between its sides
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t0 = (lo[axis] - o[axis]) / d[axis];
+        float t1 = (hi[axis] - o[axis]) / d[axis];
+        if (t0 > t1) {
+            const float tmp = t0;
+            t0 = t1;
+            t1 = tmp;
+        }
+        tenter = SDL_max(tenter, t0);
+        texit = SDL_min(texit, t1);
+        if (tenter > texit) return false;
+    }
+    *t = tenter;
+    return true;
+}
+
+static bool is_overlapping (SDL_FRect a, SDL_FRect b) {
+    // rectangles that only touch along an edge don't overlap
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static SDL_FRect unite (SDL_FRect a, SDL_FRect b) {
+    const float x0 = SDL_min(a.x, b.x);
+    const float y0 = SDL_min(a.y, b.y);
+    const float x1 = SDL_max(a.x + a.w, b.x + b.w);
+    const float y1 = SDL_max(a.y + a.h, b.y + b.h);
+    return (SDL_FRect) {
+        .h = y1 - y0,
+        .w = x1 - x0,
+        .x = x0,
+        .y = y0,
+    };
+}
+
+void bvh_delete (struct bvh ** self) {
+    SDL_free((*self)->nodes);
+    (*self)->nodes = nullptr;
+    SDL_free((*self)->rects);
+    (*self)->rects = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+}
+
+struct bvh * bvh_new (const SDL_FRect * rects, int nrects) {
+    struct bvh * self = (struct bvh *) allocate(1, sizeof(struct bvh));
+
+    // a binary tree with at least one rectangle per leaf has fewer than 2 * nrects nodes
+    self->nodes = (struct node *) allocate((size_t) SDL_max(2 * nrects, 1), sizeof(struct node));
+    self->rects = (SDL_FRect *) allocate((size_t) SDL_max(nrects, 1), sizeof(SDL_FRect));
+    self->nrects = nrects;
+    if (nrects == 0) {
+        return self;
+    }
+
+    // the items are sorted in place while building, and end up in the order of the leaves
+    struct item * items = (struct item *) allocate((size_t) nrects, sizeof(struct item));
+    for (int i = 0; i < nrects; i++) {
+        items[i] = (struct item) {
+            .center = (SDL_FPoint) {
+                .x = rects[i].x + rects[i].w / 2.0f,
+                .y = rects[i].y + rects[i].h / 2.0f,
+            },
+            .rect = rects[i],
+        };
+    }
+    build(self, items, 0, nrects);
+    SDL_free(items);
+    return self;
+}
+
+bool bvh_query_ray (const struct bvh * self, SDL_FPoint origin, SDL_FPoint direction, float tmax, float * t) {
+    // find the first rectangle that the ray from `origin` along `direction` hits, for t in
+    // [0, tmax]; subtrees that the ray enters after the closest hit so far are skipped, and of
+    // two children, the one that the ray enters first is visited first
+    if (self->nnodes == 0) return false;
+    float tbest = FLT_MAX;
+    int stack[BVH_DEPTH_MAX];
+    int nstack = 0;
+    stack[nstack++] = 0;
+    while (nstack > 0) {
+        const int inode = stack[--nstack];
+        const struct node * node = &self->nodes[inode];
+        float tnode = 0.0f;
+        if (!intersect_ray(node->bounds, origin, direction, tmax, &tnode) || tnode >= tbest) continue;
+        if (node->n > 0) {
+            for (int i = node->ifirst; i < node->ifirst + node->n; i++) {
+                float trect = 0.0f;
+                if (intersect_ray(self->rects[i], origin, direction, tmax, &trect) && trect < tbest) {
+                    tbest = trect;
+                }
+            }
+            continue;
+        }
+        float tleft = FLT_MAX;
+        float tright = FLT_MAX;
+        intersect_ray(self->nodes[inode + 1].bounds, origin, direction, tmax, &tleft);
+        intersect_ray(self->nodes[node->iright].bounds, origin, direction, tmax, &tright);
+        const bool is_left_first = tleft <= tright;
+        stack[nstack++] = is_left_first ? node->iright : inode + 1;
+        stack[nstack++] = is_left_first ? inode + 1 : node->iright;
+    }
+    if (tbest == FLT_MAX) return false;
+    *t = tbest;
+    return true;
+}
+
+void bvh_visit_aabb (const struct bvh * self, SDL_FRect aabb, BvhVisitFunction visit, void * userdata) {
+    // visit only the subtrees whose bounds overlap `aabb`
+    if (self->nnodes == 0) return;
+    int stack[BVH_DEPTH_MAX];
+    int nstack = 0;
+    stack[nstack++] = 0;
+    while (nstack > 0) {
+        const int inode = stack[--nstack];
+        const struct node * node = &self->nodes[inode];
+        if (!is_overlapping(node->bounds, aabb)) continue;
+        if (node->n > 0) {
+            for (int i = node->ifirst; i < node->ifirst + node->n; i++) {
+                if (!is_overlapping(self->rects[i], aabb)) continue;
+                if (!visit(self->rects[i], userdata)) return;
+            }
+            continue;
+        }
+        stack[nstack++] = node->iright;
+        stack[nstack++] = inode + 1;
+    }
+}
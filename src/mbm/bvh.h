@@ -0,0 +1,19 @@
+#ifndef MBM_BVH_H_INCLUDED
+#define MBM_BVH_H_INCLUDED
+#include "mbm/abi.h"
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+
+// `struct bvh` is an opaque data structure; it's a static bounding volume hierarchy over a set
+// of rectangles, for finding the ones that overlap a box or that a ray hits first. Only the
+// implementation has access to its layout.
+struct bvh;
+
+// called for each rectangle that overlaps the queried box; returning false stops the query
+typedef bool (*BvhVisitFunction)(SDL_FRect rect, void * userdata);
+
+MBM_NO_ABI void bvh_delete (struct bvh ** self);
+MBM_NO_ABI struct bvh * bvh_new (const SDL_FRect * rects, int nrects);
+MBM_NO_ABI bool bvh_query_ray (const struct bvh * self, SDL_FPoint origin, SDL_FPoint direction, float tmax, float * t);
+MBM_NO_ABI void bvh_visit_aabb (const struct bvh * self, SDL_FRect aabb, BvhVisitFunction visit, void * userdata);
+
+#endif
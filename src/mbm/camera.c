@@ -0,0 +1,106 @@
+#include "camera.h"
+#include "mbm/dims.h"             // struct dims
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_stdinc.h"      // SDL_calloc, SDL_free, SDL_max, SDL_min
+#include <stdlib.h>               // exit
+
+// the dead zone is the part of the view, centered, that the target can move around in without
+// the camera following; expressed as a fraction of the view's width and height
+#define CAMERA_DEADZONE_FRACTION_H 0.5f
+#define CAMERA_DEADZONE_FRACTION_W 0.25f
+
+// declare properties of `struct camera`
+struct camera {
+    SDL_FRect bounds;                         // pixels, the view stays inside of these
+    SDL_FRect deadzone;                       // pixels, relative to the view's top left corner
+    SDL_FRect view;                           // pixels; the position keeps its fractional part
+};
+
+// define pointer to singleton instance of `struct camera`
+static struct camera * singleton = nullptr;
+
+// forward declaration of static functions
+static float clamp_to_bounds (float x, float bounds_x, float bounds_w, float view_w);
+
+static float clamp_to_bounds (float x, float bounds_x, float bounds_w, float view_w) {
+    // a level that's smaller than the view is kept at the view's top left
+    const float x_max = SDL_max(bounds_x, bounds_x + bounds_w - view_w);
+    return SDL_min(SDL_max(x, bounds_x), x_max);
+}
+
+void camera_delete (struct camera ** self) {
+    SDL_free(*self);
+    *self = nullptr;
+    singleton = nullptr;
+}
+
+void camera_follow (struct camera * self, SDL_FRect target) {
+    // move the view by no more than it takes to get `target` back inside the dead zone
+    const float x0 = self->view.x + self->deadzone.x;
+    const float x1 = x0 + self->deadzone.w;
+    const float y0 = self->view.y + self->deadzone.y;
+    const float y1 = y0 + self->deadzone.h;
+    float x = self->view.x;
+    float y = self->view.y;
+    if (target.x < x0) {
+        x -= x0 - target.x;
+    } else if (target.x + target.w > x1) {
+        x += target.x + target.w - x1;
+    }
+    if (target.y < y0) {
+        y -= y0 - target.y;
+    } else if (target.y + target.h > y1) {
+        y += target.y + target.h - y1;
+    }
+    self->view.x = clamp_to_bounds(x, self->bounds.x, self->bounds.w, self->view.w);
+    self->view.y = clamp_to_bounds(y, self->bounds.y, self->bounds.h, self->view.h);
+}
+
+SDL_FPoint camera_get_offset (const struct camera * self) {
+    // what to add to world coordinates to get view coordinates
+    return (SDL_FPoint) {
+        .x = -self->view.x,
+        .y = -self->view.y,
+    };
+}
+
+SDL_FRect camera_get_view (const struct camera * self) {
+    return self->view;
+}
+
+void camera_init (struct camera * self, const struct dims * dims, SDL_FRect bounds) {
+    const float h = (float) dims->view.h;
+    const float w = (float) dims->view.w;
+    *self = (struct camera) {
+        .bounds = bounds,
+        .deadzone = (SDL_FRect) {
+            .h = h * CAMERA_DEADZONE_FRACTION_H,
+            .w = w * CAMERA_DEADZONE_FRACTION_W,
+            .x = w * (1.0f - CAMERA_DEADZONE_FRACTION_W) / 2.0f,
+            .y = h * (1.0f - CAMERA_DEADZONE_FRACTION_H) / 2.0f,
+        },
+        .view = (SDL_FRect) {
+            .h = h,
+            .w = w,
+            .x = bounds.x,
+            .y = bounds.y,
+        },
+    };
+}
+
+struct camera * camera_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct camera *) SDL_calloc(1, sizeof(struct camera));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct camera, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
@@ -0,0 +1,18 @@
+#ifndef MBM_CAMERA_H_INCLUDED
+#define MBM_CAMERA_H_INCLUDED
+#include "mbm/abi.h"
+#include "mbm/dims.h"             // struct dims
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+
+// `struct camera` is an opaque data structure;
+// only the implementation has access to its layout
+struct camera;
+
+MBM_NO_ABI void camera_delete (struct camera ** self);
+MBM_NO_ABI void camera_follow (struct camera * self, SDL_FRect target);
+MBM_NO_ABI SDL_FPoint camera_get_offset (const struct camera * self);
+MBM_NO_ABI SDL_FRect camera_get_view (const struct camera * self);
+MBM_NO_ABI void camera_init (struct camera * self, const struct dims * dims, SDL_FRect bounds);
+MBM_NO_ABI struct camera * camera_new (void);
+
+#endif
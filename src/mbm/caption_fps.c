@@ -1,22 +1,36 @@
 #include "mbm/caption_fps.h"      // struct caption_fps and associated functions
 #include "mbm/timings.h"          // struct timings and associated functions
+#include "profiler.h"             // MBM_PROFILE_SCOPE
+#include "sprites.h"              // struct sprites, sprites_get_ncalls, sprites_push_quads, SPRITES_LAYER_OVERLAY
+#include "text.h"                 // struct text and associated functions
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_log.h"         // SDL_LogCritical
-#include "SDL3/SDL_pixels.h"      // SDL_Color
-#include "SDL3/SDL_rect.h"        // SDL_FRect
-#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_RenderTexture
+#include "SDL3/SDL_pixels.h"      // SDL_Color, SDL_FColor
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Vertex
 #include "SDL3/SDL_stdinc.h"      // SDL_snprintf, SDL_free, SDL_calloc
-#include "SDL3/SDL_surface.h"     // SDL_surface
-#include <SDL3_ttf/SDL_ttf.h>     // TTF_Font, TTF_OpenFont, TTF_CloseFont, TTF_RenderText_Solid
 #include <stdint.h>               // int64_t
 #include <stdlib.h>               // exit
 
+// number of frames shown in the frame graph, one pixel wide each
+#define CAPTION_FPS_NBARS 300
+
+// the frame graph consists of a backdrop, a reference line, and the bars
+#define CAPTION_FPS_NQUADS (CAPTION_FPS_NBARS + 2)
+
 // declare properties of `struct caption_fps`
 struct caption_fps {
     SDL_Color fgcolor;
-    TTF_Font * font;
+    struct text * glyphs;
+    struct {
+        float hmax;                           // seconds, frame duration at the top of the graph
+        bool is_on;
+        int nquads;
+        char text[80];
+        SDL_Vertex vertices[4 * CAPTION_FPS_NQUADS];
+        SDL_FRect wld;
+    } graph;
     bool is_on;
-    float ptsize;
     int64_t interval;
     float scale;
     int64_t texpires;
@@ -28,67 +42,79 @@ struct caption_fps {
 static struct caption_fps * singleton = nullptr;
 
 // forward function declarations
-static TTF_Font * load_font (const char * relpath, float ptsize);
+static void set_quad (SDL_Vertex * vertices, SDL_FRect rect, SDL_FColor color);
+static void update_graph (struct caption_fps * self, const struct timings * timings);
+
+static void set_quad (SDL_Vertex * vertices, SDL_FRect rect, SDL_FColor color) {
+    vertices[0] = (SDL_Vertex) { .position = { rect.x, rect.y }, .color = color };
+    vertices[1] = (SDL_Vertex) { .position = { rect.x + rect.w, rect.y }, .color = color };
+    vertices[2] = (SDL_Vertex) { .position = { rect.x + rect.w, rect.y + rect.h }, .color = color };
+    vertices[3] = (SDL_Vertex) { .position = { rect.x, rect.y + rect.h }, .color = color };
+}
+
+static void update_graph (struct caption_fps * self, const struct timings * timings) {
+    const SDL_FRect wld = self->graph.wld;
+    const float hmax = self->graph.hmax;
+
+    // backdrop
+    int nquads = 0;
+    set_quad(&self->graph.vertices[4 * nquads++], wld, (SDL_FColor) { 0.0f, 0.0f, 0.0f, 0.5f });
+
+    // reference line at 60 FPS
+    set_quad(&self->graph.vertices[4 * nquads++], (SDL_FRect) {
+        .h = 1.0f,
+        .w = wld.w,
+        .x = wld.x,
+        .y = wld.y + wld.h * (1.0f - (1.0f / 60.0f) / hmax),
+    }, (SDL_FColor) { 1.0f, 1.0f, 1.0f, 0.5f });
+
+    // one bar per frame, oldest on the left, colored by how many 60 FPS frames it took
+    float durations[CAPTION_FPS_NBARS];
+    const int n = timings_get_frame_durations(timings, durations, CAPTION_FPS_NBARS);
+    for (int i = 0; i < n; i++) {
+        const float h = wld.h * SDL_min(durations[i] / hmax, 1.0f);
+        const SDL_FColor color = durations[i] <= 1.05f / 60.0f ? (SDL_FColor) { 0.0f, 1.0f, 0.0f, 1.0f } :
+                                 durations[i] <= 2.05f / 60.0f ? (SDL_FColor) { 1.0f, 1.0f, 0.0f, 1.0f } :
+                                                                 (SDL_FColor) { 1.0f, 0.0f, 0.0f, 1.0f };
+        set_quad(&self->graph.vertices[4 * nquads++], (SDL_FRect) {
+            .h = h,
+            .w = 1.0f,
+            .x = wld.x + wld.w - (float) (n - i),
+            .y = wld.y + wld.h - h,
+        }, color);
+    }
+    self->graph.nquads = nquads;
+}
 
 void caption_fps_delete (struct caption_fps ** self) {
-    TTF_CloseFont((*self)->font);
-    (*self)->font = nullptr;
+    text_delete(&(*self)->glyphs);
     SDL_free(*self);
     *self = nullptr;
 }
 
-void caption_fps_draw (const struct caption_fps * self, SDL_Renderer * renderer) {
-    if (self->is_on) {
-        // create surface from string
-        SDL_Surface * surface = TTF_RenderText_Solid(self->font, self->text, 0, self->fgcolor);
-        if (surface == nullptr) {
-            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create surface for caption_fps text, aborting; %s\n",
-                            SDL_GetError());
-            exit(1);
-        }
-
-        // create texture from surface
-        SDL_Texture * texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (texture == nullptr) {
-            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                            "Couldn't create texture for caption_fps text, aborting; %s\n",
-                            SDL_GetError());
-            exit(1);
-        }
-
-        // set texture scale mode
-        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
-
-        {
-            // get the width and height of the rendered text
-            int w = -1;
-            int h = -1;
-            TTF_GetStringSize(self->font, self->text, 0, &w, &h);
-
-            // render the texture on the screen
-            SDL_FRect wld = (SDL_FRect) {
-                .w = (float) w * self->scale,
-                .h = (float) h * self->scale,
-                .x = self->wld.x,
-                .y = self->wld.y,
-            };
-            SDL_RenderTexture(renderer, texture, nullptr, &wld);
-        }
-
-        // free resources related to texture
-        SDL_DestroyTexture(texture);
-        texture = nullptr;
-
-        // free resources related to surface
-        SDL_DestroySurface(surface);
-        surface = nullptr;
+void caption_fps_draw (const struct caption_fps * self, struct sprites * sprites) {
+    MBM_PROFILE_SCOPE("caption_fps_draw");
+    if (!self->is_on) return;
+    text_draw(self->glyphs, sprites, self->text, self->wld, self->scale, self->fgcolor);
+    if (self->graph.is_on) {
+        // the whole graph is a single run of untextured quads, underneath the text
+        sprites_push_quads(sprites, SPRITES_LAYER_OVERLAY, nullptr, self->graph.vertices, self->graph.nquads);
+        const SDL_FPoint wld = (SDL_FPoint) {
+            .x = self->graph.wld.x,
+            .y = self->graph.wld.y + self->graph.wld.h,
+        };
+        text_draw(self->glyphs, sprites, self->graph.text, wld, self->scale, self->fgcolor);
     }
 }
 
-void caption_fps_init (struct caption_fps * self) {
+void caption_fps_init (struct caption_fps * self, SDL_Renderer * renderer, struct resources * resources) {
 
     float ptsize = 48.0f;
+    float scale = 0.25f;
+    struct text * glyphs = text_new("../share/mbm/assets/fonts/JetBrainsMono-SemiBold.ttf", ptsize, renderer, resources);
+    float h = -1.0f;
+    float w = -1.0f;
+    text_get_size(glyphs, "--- FPS", scale, &w, &h);
 
     *self = (struct caption_fps) {
         .fgcolor = (SDL_Color) {
@@ -97,11 +123,22 @@ void caption_fps_init (struct caption_fps * self) {
             .b = 0,
             .a = SDL_ALPHA_OPAQUE,
         },
-        .font = load_font("../share/mbm/assets/fonts/JetBrainsMono-SemiBold.ttf", ptsize),
+        .glyphs = glyphs,
+        .graph = {
+            .hmax = 3.0f / 60.0f,
+            .is_on = false,
+            .nquads = 0,
+            .text = "",
+            .wld = (SDL_FRect) {
+                .h = 48.0f,
+                .w = (float) CAPTION_FPS_NBARS,
+                .x = 0.0f,
+                .y = h,
+            },
+        },
         .interval = (int64_t) 5e5,
         .is_on = true,
-        .ptsize = ptsize,
-        .scale = 0.25,
+        .scale = scale,
         .texpires = (int64_t) 0,
         .text = "--- FPS",
         .wld = (SDL_FPoint) {
@@ -130,31 +167,34 @@ void caption_fps_toggle (struct caption_fps * self) {
     self->is_on = !self->is_on;
 }
 
-void caption_fps_update (struct caption_fps * self, const struct timings * timings) {
-    int64_t tnow = timings_get_frame_timestamp(timings);
-    if (tnow > self->texpires) {
-        int fps = (int) (1.0f / timings_get_frame_duration(timings));
-        SDL_snprintf(&self->text[0], 24, "%d FPS", fps);
-        self->texpires = tnow + self->interval;
-    }
+void caption_fps_toggle_graph (struct caption_fps * self) {
+    self->graph.is_on = !self->graph.is_on;
 }
 
-static TTF_Font * load_font (const char * relpath, float ptsize) {
+bool caption_fps_update (struct caption_fps * self, const struct timings * timings, const struct sprites * sprites) {
 
-    char * path = nullptr;
-    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
-
-    TTF_Font * font = TTF_OpenFont(path, ptsize);
-    if (font == nullptr) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Couldn't load font file, aborting; %s\n",
-                        SDL_GetError());
-        exit(1);
+    // returns whether the caption looks different than before, i.e. whether it needs redrawing
+    bool is_changed = false;
+    int64_t tnow = timings_get_frame_timestamp(timings);
+    float duration = timings_get_frame_duration_avg(timings);
+    if (tnow > self->texpires && duration > 0.0f) {
+        int fps = (int) (1.0f / duration);
+        SDL_snprintf(&self->text[0], sizeof self->text, "%d FPS", fps);
+        // the draw calls are those of the last frame that was flushed, which shows whether the
+        // sprite batch keeps them down to about one per texture
+        SDL_snprintf(&self->graph.text[0], sizeof self->graph.text, "min %.1f avg %.1f p99 %.1f max %.1f ms, missed %d, %d calls",
+                     timings_get_frame_duration_min(timings) * 1e3f,
+                     timings_get_frame_duration_avg(timings) * 1e3f,
+                     timings_get_frame_duration_p99(timings) * 1e3f,
+                     timings_get_frame_duration_max(timings) * 1e3f,
+                     timings_get_nmissed(timings),
+                     sprites_get_ncalls(sprites));
+        self->texpires = tnow + self->interval;
+        is_changed = self->is_on;
     }
-
-    // free resources
-    SDL_free(path);
-    path = nullptr;
-
-    return font;
+    if (self->is_on && self->graph.is_on) {
+        update_graph(self, timings);
+        is_changed = true;
+    }
+    return is_changed;
 }
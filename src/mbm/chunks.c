@@ -0,0 +1,182 @@
+#include "chunks.h"
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_filesystem.h"  // SDL_GetBasePath
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_free, SDL_max, SDL_min
+#include <errno.h>                // errno
+#include <fcntl.h>                // open, O_RDONLY
+#include <stddef.h>               // size_t
+#include <stdint.h>               // uint8_t, uint32_t, uintptr_t
+#include <stdlib.h>               // exit
+#include <string.h>               // strerror
+#include <sys/mman.h>             // madvise, mmap, munmap, MADV_WILLNEED, MAP_FAILED, MAP_PRIVATE, PROT_READ
+#include <sys/stat.h>             // fstat, struct stat
+#include <unistd.h>               // close, sysconf, _SC_PAGESIZE
+
+// an IDX file starts with 2 zero bytes, a byte for the element type, a byte for the number of
+// dimensions, and then the length of each dimension as a big-endian uint32
+#define CHUNKS_HEADER_SIZE 12
+#define CHUNKS_TYPE_UINT8 0x08
+
+// declare properties of `struct chunks`
+struct chunks {
+    const uint8_t * body;                     // the tile map file's body, one byte per tile, row-major
+    struct {
+        uint8_t * mem;                        // the tile map file, mapped read-only
+        size_t size;
+    } mapping;
+    int ncols;                                // tiles
+    int nrows;                                // tiles
+    struct {
+        int ichunk_col_e;                     // end of the chunk columns (exclusive)
+        int ichunk_col_s;                     // start of the chunk columns
+        int ichunk_row_e;                     // end of the chunk rows (exclusive)
+        int ichunk_row_s;                     // start of the chunk rows
+    } prefetched;                             // what chunks_prefetch() last advised the kernel of
+};
+
+// forward declaration of static functions
+static void * allocate (size_t n, size_t size);
+static uint8_t * map_file (const char * relpath, size_t * size);
+static uint32_t read_uint32_be (const uint8_t * bytes);
+
+static void * allocate (size_t n, size_t size) {
+    void * mem = SDL_calloc(n, size);
+    if (mem == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Error allocating dynamic memory for tile chunks, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return mem;
+}
+
+static uint8_t * map_file (const char * relpath, size_t * size) {
+    char * path = nullptr;
+    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't open tile map file, aborting; %s\n",
+                        strerror(errno));
+        exit(1);
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) != 0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't determine size of tile map file, aborting; %s\n",
+                        strerror(errno));
+        exit(1);
+    }
+    if ((size_t) st.st_size < CHUNKS_HEADER_SIZE) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "tile map file is too small to hold a header, aborting.\n");
+        exit(1);
+    }
+
+    // map the file read-only: its pages are the page cache's (and are shared with other processes
+    // that map the same level), so they are clean and the kernel can drop any that go unused
+    uint8_t * mem = (uint8_t *) mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem == MAP_FAILED) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't map tile map file into memory, aborting; %s\n",
+                        strerror(errno));
+        exit(1);
+    }
+    close(fd);
+    SDL_free(path);
+    path = nullptr;
+    *size = (size_t) st.st_size;
+    return mem;
+}
+
+static uint32_t read_uint32_be (const uint8_t * bytes) {
+    return ((uint32_t) bytes[0] << 24) | ((uint32_t) bytes[1] << 16) | ((uint32_t) bytes[2] << 8) | (uint32_t) bytes[3];
+}
+
+void chunks_delete (struct chunks ** self) {
+    munmap((*self)->mapping.mem, (*self)->mapping.size);
+    (*self)->mapping.mem = nullptr;
+    (*self)->body = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+}
+
+int chunks_get_ncols (const struct chunks * self) {
+    return self->ncols;
+}
+
+int chunks_get_nrows (const struct chunks * self) {
+    return self->nrows;
+}
+
+uint8_t chunks_get_tile (const struct chunks * self, int irow, int icol) {
+    return self->body[(size_t) irow * self->ncols + icol];
+}
+
+struct chunks * chunks_new (const char * relpath) {
+    struct chunks * self = (struct chunks *) allocate(1, sizeof(struct chunks));
+
+    // map the file and check its header in place; the body stays on disk until it's touched
+    size_t size = 0;
+    uint8_t * mem = map_file(relpath, &size);
+    if (mem[0] != 0 || mem[1] != 0 || mem[2] != CHUNKS_TYPE_UINT8 || mem[3] != 2) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "tile map file should hold a 2-dimensional array of uint8, aborting.\n");
+        exit(1);
+    }
+    const uint32_t nrows = read_uint32_be(&mem[4]);
+    const uint32_t ncols = read_uint32_be(&mem[8]);
+    if (nrows == 0 || ncols == 0 || nrows > INT32_MAX / ncols) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "tile map file has unsupported dimensions %u x %u, aborting.\n", nrows, ncols);
+        exit(1);
+    }
+    if (size < CHUNKS_HEADER_SIZE + (size_t) nrows * ncols) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "tile map file is truncated, aborting.\n");
+        exit(1);
+    }
+
+    *self = (struct chunks) {
+        .body = &mem[CHUNKS_HEADER_SIZE],
+        .mapping = {
+            .mem = mem,
+            .size = size,
+        },
+        .ncols = (int) ncols,
+        .nrows = (int) nrows,
+        .prefetched = {},
+    };
+    return self;
+}
+
+void chunks_prefetch (struct chunks * self, int irow_s, int irow_e, int icol_s, int icol_e) {
+    // round the (half-open) range of tiles out to whole chunks, clipped to the level, such that
+    // the kernel is only asked again once the range crosses a chunk boundary
+    const int ichunk_row_s = SDL_max(irow_s, 0) / CHUNKS_SIZE;
+    const int ichunk_row_e = (SDL_min(irow_e, self->nrows) + CHUNKS_SIZE - 1) / CHUNKS_SIZE;
+    const int ichunk_col_s = SDL_max(icol_s, 0) / CHUNKS_SIZE;
+    const int ichunk_col_e = (SDL_min(icol_e, self->ncols) + CHUNKS_SIZE - 1) / CHUNKS_SIZE;
+    if (ichunk_row_s == self->prefetched.ichunk_row_s && ichunk_row_e == self->prefetched.ichunk_row_e &&
+        ichunk_col_s == self->prefetched.ichunk_col_s && ichunk_col_e == self->prefetched.ichunk_col_e) {
+        return;
+    }
+    self->prefetched.ichunk_col_e = ichunk_col_e;
+    self->prefetched.ichunk_col_s = ichunk_col_s;
+    self->prefetched.ichunk_row_e = ichunk_row_e;
+    self->prefetched.ichunk_row_s = ichunk_row_s;
+
+    // a chunk is a stretch of each of its rows in the mapping; have the kernel read in the pages
+    // under those stretches ahead of the view, rather than fault them in one by one mid-frame
+    const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    const int irow_e_clipped = SDL_min(ichunk_row_e * CHUNKS_SIZE, self->nrows);
+    const int icol_s_clipped = ichunk_col_s * CHUNKS_SIZE;
+    const int icol_e_clipped = SDL_min(ichunk_col_e * CHUNKS_SIZE, self->ncols);
+    for (int irow = ichunk_row_s * CHUNKS_SIZE; irow < irow_e_clipped; irow++) {
+        const uintptr_t s = (uintptr_t) &self->body[(size_t) irow * self->ncols + icol_s_clipped];
+        const uintptr_t e = (uintptr_t) &self->body[(size_t) irow * self->ncols + icol_e_clipped];
+        const uintptr_t s_aligned = s & ~(uintptr_t) (page_size - 1);
+        madvise((void *) s_aligned, e - s_aligned, MADV_WILLNEED);
+    }
+}
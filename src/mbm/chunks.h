@@ -0,0 +1,21 @@
+#ifndef MBM_CHUNKS_H_INCLUDED
+#define MBM_CHUNKS_H_INCLUDED
+#include "mbm/abi.h"
+#include <stdint.h>               // uint8_t
+
+// chunks are square blocks of this many tiles per side; they're the unit in which the tile map
+// is read ahead of the view, while the tiles themselves are read straight from the mapped file
+#define CHUNKS_SIZE 32
+
+// `struct chunks` is an opaque data structure;
+// only the implementation has access to its layout
+struct chunks;
+
+MBM_NO_ABI void chunks_delete (struct chunks ** self);
+MBM_NO_ABI int chunks_get_ncols (const struct chunks * self);
+MBM_NO_ABI int chunks_get_nrows (const struct chunks * self);
+MBM_NO_ABI uint8_t chunks_get_tile (const struct chunks * self, int irow, int icol);
+MBM_NO_ABI struct chunks * chunks_new (const char * relpath);
+MBM_NO_ABI void chunks_prefetch (struct chunks * self, int irow_s, int irow_e, int icol_s, int icol_e);
+
+#endif
@@ -0,0 +1,175 @@
+#include "collisions.h"
+#include "bvh.h"                  // struct bvh, bvh_visit_aabb
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_stdinc.h"      // SDL_fabsf, SDL_max, SDL_min
+#include <float.h>                // FLT_MAX
+
+// pixels; a sweep that starts this close to touching a collider, or overlapping it by this much,
+// still counts as hitting it, which absorbs the rounding errors of resolving earlier contacts
+#define COLLISIONS_SKIN 0.01f
+
+// the box that collisions_sweep_aabb() moves, and the first hit of the colliders visited so far
+struct impact {
+    SDL_FRect aabb;
+    SDL_FPoint delta;
+    SDL_FPoint normal;
+    float toi;
+};
+
+// the box that collisions_resolve_penetration() pushes out, and the collider that it overlaps
+// most of the ones visited so far
+struct penetration {
+    SDL_FRect aabb;
+    int noverlapping;
+    float overlap_area;
+    SDL_FPoint push;
+};
+
+// forward declaration of static functions
+static bool measure_penetration (SDL_FRect collider, void * userdata);
+static bool sweep (SDL_FRect collider, SDL_FRect aabb, SDL_FPoint delta, float * toi, SDL_FPoint * normal);
+static bool sweep_collider (SDL_FRect collider, void * userdata);
+
+static bool measure_penetration (SDL_FRect collider, void * userdata) {
+    // keep the push out of the collider that the box overlaps most, along the axis of least overlap
+    struct penetration * penetration = (struct penetration *) userdata;
+    const SDL_FRect aabb = penetration->aabb;
+    const float x0 = collider.x;
+    const float x1 = x0 + collider.w;
+    const float y0 = collider.y;
+    const float y1 = y0 + collider.h;
+    const float overlap_w = SDL_min(aabb.x + aabb.w, x1) - SDL_max(aabb.x, x0);
+    const float overlap_h = SDL_min(aabb.y + aabb.h, y1) - SDL_max(aabb.y, y0);
+    if (overlap_w <= 0.0f || overlap_h <= 0.0f) return true;
+    penetration->noverlapping++;
+    if (overlap_w * overlap_h <= penetration->overlap_area) return true;
+    penetration->overlap_area = overlap_w * overlap_h;
+    if (overlap_w < overlap_h) {
+        const bool is_left_of_collider = aabb.x + aabb.w / 2.0f < (x0 + x1) / 2.0f;
+        penetration->push = (SDL_FPoint) {
+            .x = is_left_of_collider ? -overlap_w : overlap_w,
+            .y = 0.0f,
+        };
+    } else {
+        const bool is_above_collider = aabb.y + aabb.h / 2.0f < (y0 + y1) / 2.0f;
+        penetration->push = (SDL_FPoint) {
+            .x = 0.0f,
+            .y = is_above_collider ? -overlap_h : overlap_h,
+        };
+    }
+    return true;
+}
+
+static bool sweep (SDL_FRect collider, SDL_FRect aabb, SDL_FPoint delta, float * toi, SDL_FPoint * normal) {
+    // moving `aabb` against `collider` is the same as moving the top left corner of `aabb` as a
+    // point against `collider` grown by the size of `aabb`; clip the point's path against the
+    // grown collider's slabs, one axis at a time
+    const float o[2] = { aabb.x, aabb.y };
+    const float d[2] = { delta.x, delta.y };
+    const float lo[2] = { collider.x - aabb.w, collider.y - aabb.h };
+    const float hi[2] = { collider.x + collider.w, collider.y + collider.h };
+    float tenter = -FLT_MAX;
+    float texit = FLT_MAX;
+    int iaxis = -1;
+    for (int axis = 0; axis < 2; axis++) {
+        if (d[axis] == 0.0f) {
+            // not moving along this axis, so sliding along the collider's edge doesn't hit it,
+            // even when rounding put the path a little inside; otherwise, the seam between two
+            // colliders that form one floor would stop a duck walking across it
+            if (o[axis] <= lo[axis] + COLLISIONS_SKIN || o[axis] >= hi[axis] - COLLISIONS_SKIN) return false;
+            continue;
+        }
+        // distances to the near and the far side along the direction of movement; the near one
+        // is negative when the path starts past it
+        const float gap = d[axis] > 0.0f ? lo[axis] - o[axis] : o[axis] - hi[axis];
+        const float speed = SDL_fabsf(d[axis]);
+        const float t0 = gap / speed;
+        const float t1 = (gap + hi[axis] - lo[axis]) / speed;
+        if (t0 > tenter) {
+            tenter = t0;
+            iaxis = axis;
+        }
+        texit = SDL_min(texit, t1);
+    }
+    if (iaxis < 0 || tenter > texit || tenter >= 1.0f || texit <= 0.0f) return false;
+
+    // a path that starts deeper inside than the skin is left to collisions_resolve_penetration()
+    const float gap = tenter * SDL_fabsf(d[iaxis]);
+    if (gap < -COLLISIONS_SKIN) return false;
+    *toi = SDL_max(tenter, 0.0f);
+    *normal = (SDL_FPoint) {
+        .x = iaxis == 0 ? (d[0] > 0.0f ? -1.0f : 1.0f) : 0.0f,
+        .y = iaxis == 1 ? (d[1] > 0.0f ? -1.0f : 1.0f) : 0.0f,
+    };
+    return true;
+}
+
+static bool sweep_collider (SDL_FRect collider, void * userdata) {
+    // keep the earliest time of impact of all the colliders that the swept box overlaps; they
+    // come in the order of the hierarchy, not nearest first, so all of them need testing
+    struct impact * impact = (struct impact *) userdata;
+    float toi = 1.0f;
+    SDL_FPoint normal = {};
+    if (sweep(collider, impact->aabb, impact->delta, &toi, &normal) && toi < impact->toi) {
+        impact->toi = toi;
+        impact->normal = normal;
+    }
+    return true;
+}
+
+SDL_FPoint collisions_resolve_penetration (const struct bvh * bvh, SDL_FRect aabb) {
+    // each pass pushes `aabb` out of the collider that it overlaps most, along the axis of least
+    // overlap; neighboring solid tiles are merged into one collider, so there are no seams
+    // between them to catch `aabb`. Every pass removes at least one collider from the overlap,
+    // so the number of passes is bounded by the number of colliders that `aabb` overlaps.
+    SDL_FPoint displacement = (SDL_FPoint) {
+        .x = 0.0f,
+        .y = 0.0f,
+    };
+    int npasses_max = 1;
+    for (int ipass = 0; ipass < npasses_max; ipass++) {
+        struct penetration penetration = (struct penetration) {
+            .aabb = aabb,
+            .noverlapping = 0,
+            .overlap_area = 0.0f,
+            .push = (SDL_FPoint) {
+                .x = 0.0f,
+                .y = 0.0f,
+            },
+        };
+        bvh_visit_aabb(bvh, aabb, measure_penetration, &penetration);
+        if (penetration.overlap_area == 0.0f) break;
+        if (ipass == 0) {
+            npasses_max = penetration.noverlapping;
+        }
+        aabb.x += penetration.push.x;
+        aabb.y += penetration.push.y;
+        displacement.x += penetration.push.x;
+        displacement.y += penetration.push.y;
+    }
+    return displacement;
+}
+
+float collisions_sweep_aabb (const struct bvh * bvh, SDL_FRect aabb, SDL_FPoint delta, SDL_FPoint * normal) {
+    // find how far `aabb` can move along `delta` before it hits a collider, as a fraction of
+    // `delta` in [0, 1]; `normal` receives the outward normal of the side that's hit, or zero when
+    // nothing is in the way. Colliders that `aabb` already overlaps don't stop it.
+    const SDL_FRect swept = (SDL_FRect) {
+        .h = aabb.h + SDL_fabsf(delta.y) + 2.0f * COLLISIONS_SKIN,
+        .w = aabb.w + SDL_fabsf(delta.x) + 2.0f * COLLISIONS_SKIN,
+        .x = SDL_min(aabb.x, aabb.x + delta.x) - COLLISIONS_SKIN,
+        .y = SDL_min(aabb.y, aabb.y + delta.y) - COLLISIONS_SKIN,
+    };
+    struct impact impact = (struct impact) {
+        .aabb = aabb,
+        .delta = delta,
+        .normal = (SDL_FPoint) {
+            .x = 0.0f,
+            .y = 0.0f,
+        },
+        .toi = 1.0f,
+    };
+    bvh_visit_aabb(bvh, swept, sweep_collider, &impact);
+    *normal = impact.normal;
+    return impact.toi;
+}
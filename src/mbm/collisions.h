@@ -0,0 +1,13 @@
+#ifndef MBM_COLLISIONS_H_INCLUDED
+#define MBM_COLLISIONS_H_INCLUDED
+#include "mbm/abi.h"
+#include "bvh.h"                  // struct bvh
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+
+// Moving boxes against the static colliders in a bounding volume hierarchy. Both functions
+// consider every collider near the box, however many there are.
+
+MBM_NO_ABI SDL_FPoint collisions_resolve_penetration (const struct bvh * bvh, SDL_FRect aabb);
+MBM_NO_ABI float collisions_sweep_aabb (const struct bvh * bvh, SDL_FRect aabb, SDL_FPoint delta, SDL_FPoint * normal);
+
+#endif
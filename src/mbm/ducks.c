@@ -0,0 +1,385 @@
+#include "mbm/ducks.h"
+#include "animations.h"           // struct animations and associated functions
+#include "atlas.h"                // struct atlas
+#include "camera.h"               // struct camera, camera_get_offset
+#include "mbm/timings.h"          // struct timings and associated functions
+#include "mbm/world.h"            // struct world and associated functions
+#include "physics.h"              // struct physics_bodies, physics_integrate
+#include "profiler.h"             // MBM_PROFILE_SCOPE
+#include "sprites.h"              // struct sprites, sprites_push, sprites_push_outline, SPRITES_LAYER_*
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_pixels.h"      // SDL_FColor
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Texture
+#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc, SDL_realloc
+#include <stddef.h>               // size_t
+#include <stdint.h>               // int64_t
+#include <stdlib.h>               // exit
+
+// upper limit on the number of times a step is swept per tick; after hitting a floor and a wall,
+// there's no movement left
+#define DUCKS_NSWEEPS_MAX 3
+
+// define enum for animation states, in the order of the animations in duck.anims.txt
+enum animation_state: uint8_t {
+    ANIMATION_STATE_IDLE = 0,
+    ANIMATION_STATE_WALKING,
+    ANIMATION_STATE_COUNT,
+};
+
+// declare properties of `struct ducks`; the per-duck properties are stored as one array per
+// property (structure of arrays), such that the update pass streams through them
+struct ducks {
+    struct animations * animations;
+    int64_t * anim_phase_shifts;
+    struct {
+        float * x;
+        float * y;
+    } bbox;
+    struct {
+        float h;
+        float w;
+        float x;                              // relative to the duck's position
+        float y;                              // relative to the duck's position
+    } bbox_shape;
+    int * ianims;
+    int * iframes;
+    bool * is_facing_right;
+    bool * is_wandering;                      // whether the duck walks by itself
+    int n;
+    int ncap;
+    struct {
+        float * x;
+        float * y;
+    } pos;
+    struct {
+        float * x;
+        float * y;
+    } pos_interp;                             // position to draw at, between `pos_prev` and `pos`
+    struct {
+        float * x;
+        float * y;
+    } pos_prev;                               // position at the start of the last tick
+    struct {
+        float h;
+        float w;
+    } size;
+    int64_t * t_frame_expires;
+    struct {
+        float * x;
+        float * y;
+    } v;
+    float vmax;                               // maximum vertical speed
+    float vwalking;
+};
+
+// forward declaration of static functions
+static void grow (struct ducks * self, int ncap);
+static void * reallocate (void * mem, int n, size_t size);
+
+// define pointer to singleton instance of `struct ducks`
+static struct ducks * singleton = nullptr;
+
+static void grow (struct ducks * self, int ncap) {
+    self->anim_phase_shifts = reallocate(self->anim_phase_shifts, ncap, sizeof(int64_t));
+    self->bbox.x = reallocate(self->bbox.x, ncap, sizeof(float));
+    self->bbox.y = reallocate(self->bbox.y, ncap, sizeof(float));
+    self->ianims = reallocate(self->ianims, ncap, sizeof(int));
+    self->iframes = reallocate(self->iframes, ncap, sizeof(int));
+    self->is_facing_right = reallocate(self->is_facing_right, ncap, sizeof(bool));
+    self->is_wandering = reallocate(self->is_wandering, ncap, sizeof(bool));
+    self->pos.x = reallocate(self->pos.x, ncap, sizeof(float));
+    self->pos.y = reallocate(self->pos.y, ncap, sizeof(float));
+    self->pos_interp.x = reallocate(self->pos_interp.x, ncap, sizeof(float));
+    self->pos_interp.y = reallocate(self->pos_interp.y, ncap, sizeof(float));
+    self->pos_prev.x = reallocate(self->pos_prev.x, ncap, sizeof(float));
+    self->pos_prev.y = reallocate(self->pos_prev.y, ncap, sizeof(float));
+    self->t_frame_expires = reallocate(self->t_frame_expires, ncap, sizeof(int64_t));
+    self->v.x = reallocate(self->v.x, ncap, sizeof(float));
+    self->v.y = reallocate(self->v.y, ncap, sizeof(float));
+    self->ncap = ncap;
+}
+
+static void * reallocate (void * mem, int n, size_t size) {
+    mem = SDL_realloc(mem, n * size);
+    if (mem == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for duck properties, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return mem;
+}
+
+void ducks_delete (struct ducks ** self) {
+    animations_delete(&(*self)->animations);
+    (*self)->animations = nullptr;
+    SDL_free((*self)->anim_phase_shifts);
+    SDL_free((*self)->bbox.x);
+    SDL_free((*self)->bbox.y);
+    SDL_free((*self)->ianims);
+    SDL_free((*self)->iframes);
+    SDL_free((*self)->is_facing_right);
+    SDL_free((*self)->is_wandering);
+    SDL_free((*self)->pos.x);
+    SDL_free((*self)->pos.y);
+    SDL_free((*self)->pos_interp.x);
+    SDL_free((*self)->pos_interp.y);
+    SDL_free((*self)->pos_prev.x);
+    SDL_free((*self)->pos_prev.y);
+    SDL_free((*self)->t_frame_expires);
+    SDL_free((*self)->v.x);
+    SDL_free((*self)->v.y);
+    SDL_free(*self);
+    *self = nullptr;
+}
+
+void ducks_draw (const struct ducks * self, struct sprites * sprites, const struct camera * camera) {
+    const SDL_FPoint offset = camera_get_offset(camera);
+    SDL_Texture * texture = animations_get_texture(self->animations);
+    const SDL_FColor white = (SDL_FColor) { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (int i = 0; i < self->n; i++) {
+        // ducks that face left use the pre-mirrored frames, so every duck is a plain quad
+        const bool is_mirrored = !self->is_facing_right[i];
+        SDL_FRect src = animations_get_frame(self->animations, self->ianims[i], self->iframes[i], is_mirrored);
+        SDL_FRect dst = (SDL_FRect) {
+            .h = self->size.h,
+            .w = self->size.w,
+            .x = self->pos_interp.x[i] + offset.x,
+            .y = self->pos_interp.y[i] + offset.y,
+        };
+        sprites_push(sprites, SPRITES_LAYER_DUCKS, texture, src, dst, white);
+    }
+#ifdef MBM_DRAW_BBOXES
+    for (int i = 0; i < self->n; i++) {
+        SDL_FRect bbox = (SDL_FRect) {
+            .h = self->bbox_shape.h,
+            .w = self->bbox_shape.w,
+            .x = self->bbox.x[i] + offset.x,
+            .y = self->bbox.y[i] + offset.y,
+        };
+        sprites_push_outline(sprites, SPRITES_LAYER_BBOXES, bbox, white);
+    }
+#endif // MBM_DRAW_BBOXES
+}
+
+SDL_FRect ducks_get_bbox (const struct ducks * self, int iduck) {
+    // the bounding box where the duck is drawn, i.e. at its interpolated position
+    return (SDL_FRect) {
+        .h = self->bbox_shape.h,
+        .w = self->bbox_shape.w,
+        .x = self->pos_interp.x[iduck] + self->bbox_shape.x,
+        .y = self->pos_interp.y[iduck] + self->bbox_shape.y,
+    };
+}
+
+void ducks_halt (struct ducks * self, int iduck) {
+    self->v.x[iduck] = 0.0f;
+    if (self->ianims[iduck] != ANIMATION_STATE_IDLE) {
+        self->ianims[iduck] = ANIMATION_STATE_IDLE;
+        // trigger animations_update_batch() in ducks_update()
+        self->t_frame_expires[iduck] = INT64_MIN;
+    }
+}
+
+void ducks_handle_collision_with_world (struct ducks * self, const struct world * world) {
+    for (int i = 0; i < self->n; i++) {
+
+        // replay the last step from where it started, and stop it where the duck first touches a
+        // collider, such that a long step can't carry the duck through a thin one; the part of
+        // the step that's left slides along the collider that was hit
+        SDL_FPoint delta = (SDL_FPoint) {
+            .x = self->pos.x[i] - self->pos_prev.x[i],
+            .y = self->pos.y[i] - self->pos_prev.y[i],
+        };
+        SDL_FRect bbox = (SDL_FRect) {
+            .h = self->bbox_shape.h,
+            .w = self->bbox_shape.w,
+            .x = self->bbox.x[i] - delta.x,
+            .y = self->bbox.y[i] - delta.y,
+        };
+        SDL_FPoint clipped = (SDL_FPoint) {
+            .x = 0.0f,
+            .y = 0.0f,
+        };
+        for (int isweep = 0; isweep < DUCKS_NSWEEPS_MAX && (delta.x != 0.0f || delta.y != 0.0f); isweep++) {
+            SDL_FPoint normal = {};
+            const float toi = world_sweep_aabb(world, bbox, delta, &normal);
+            bbox.x += toi * delta.x;
+            bbox.y += toi * delta.y;
+            delta = (SDL_FPoint) {
+                .x = (1.0f - toi) * delta.x,
+                .y = (1.0f - toi) * delta.y,
+            };
+            if (normal.x != 0.0f) {
+                clipped.x += delta.x;
+                delta.x = 0.0f;
+            }
+            if (normal.y != 0.0f) {
+                clipped.y += delta.y;
+                delta.y = 0.0f;
+            }
+        }
+
+        // push the duck out of whatever it still overlaps, e.g. after spawning inside a collider;
+        // the displacement from where the step would have taken it tells what the duck ran into.
+        // Steps that hit nothing leave the displacement at exactly zero.
+        bbox.x = self->bbox.x[i] - clipped.x;
+        bbox.y = self->bbox.y[i] - clipped.y;
+        const SDL_FPoint penetration = world_resolve_penetration(world, bbox);
+        const SDL_FPoint displacement = (SDL_FPoint) {
+            .x = penetration.x - clipped.x,
+            .y = penetration.y - clipped.y,
+        };
+        self->pos.x[i] += displacement.x;
+        self->pos.y[i] += displacement.y;
+        self->bbox.x[i] += displacement.x;
+        self->bbox.y[i] += displacement.y;
+        if (displacement.x < 0.0f && self->is_wandering[i]) {
+            // wandering duck walked into a wall on its right, so it turns around
+            ducks_walk_left(self, i);
+        } else if (displacement.x > 0.0f && self->is_wandering[i]) {
+            // wandering duck walked into a wall on its left, so it turns around
+            ducks_walk_right(self, i);
+        } else if (displacement.x != 0.0f) {
+            // duck walked into a wall
+            self->v.x[i] = 0.0f;
+        }
+        if (displacement.y != 0.0f) {
+            // duck landed on a tile, or bumped its head against one
+            self->v.y[i] = 0.0f;
+        }
+    }
+}
+
+void ducks_init (struct ducks * self, const struct atlas * atlas, int nducks_cap) {
+    float h = 32.0f;
+    float w = 32.0f;
+
+    // the animations' frames are described in assets/images/duck.anims.txt
+    struct animations * animations = animations_new("../share/mbm/assets/images/duck.anims", ANIMATION_STATE_COUNT, atlas, "duck");
+
+    *self = (struct ducks) {
+        .animations = animations,
+        .bbox_shape = {
+            .h = h - 9.0f,
+            .w = w - 24.0f,
+            .x = 12.0f,
+            .y = 9.0f,
+        },
+        .n = 0,
+        .ncap = 0,
+        .size = {
+            .h = h,
+            .w = w,
+        },
+        .vmax = 250.0f,
+        .vwalking = 20.0f,
+    };
+    grow(self, nducks_cap > 0 ? nducks_cap : 1);
+}
+
+void ducks_interpolate (struct ducks * self, float alpha) {
+    for (int i = 0; i < self->n; i++) {
+        self->pos_interp.x[i] = self->pos_prev.x[i] + alpha * (self->pos.x[i] - self->pos_prev.x[i]);
+        self->pos_interp.y[i] = self->pos_prev.y[i] + alpha * (self->pos.y[i] - self->pos_prev.y[i]);
+    }
+}
+
+void ducks_jump (struct ducks * self, int iduck) {
+    self->v.y[iduck] -= 10.0f;
+}
+
+struct ducks * ducks_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct ducks *) SDL_calloc(1, sizeof(struct ducks));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct ducks, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
+
+int ducks_spawn (struct ducks * self, float x, float y, bool is_wandering) {
+    if (self->n == self->ncap) {
+        grow(self, 2 * self->ncap);
+    }
+    const int i = self->n;
+    self->anim_phase_shifts[i] = (int64_t) 0;
+    self->bbox.x[i] = x + self->bbox_shape.x;
+    self->bbox.y[i] = y + self->bbox_shape.y;
+    self->ianims[i] = ANIMATION_STATE_IDLE;
+    self->iframes[i] = 0;
+    self->is_facing_right[i] = true;
+    self->is_wandering[i] = is_wandering;
+    self->pos.x[i] = x;
+    self->pos.y[i] = y;
+    self->pos_interp.x[i] = x;
+    self->pos_interp.y[i] = y;
+    self->pos_prev.x[i] = x;
+    self->pos_prev.y[i] = y;
+    self->t_frame_expires[i] = INT64_MIN;
+    self->v.x[i] = 0.0f;
+    self->v.y[i] = 0.0f;
+    self->n++;
+    if (is_wandering) {
+        ducks_walk_right(self, i);
+    }
+    return i;
+}
+
+void ducks_update (struct ducks * self, const struct world * world, const struct timings * timings) {
+    MBM_PROFILE_SCOPE("ducks_update");
+
+    // advance the animations of all ducks
+    const int64_t tnow = timings_get_tick_timestamp(timings);
+    const int64_t duration_idle = animations_get_animation_duration(self->animations, ANIMATION_STATE_IDLE);
+    for (int i = 0; i < self->n; i++) {
+        if (self->t_frame_expires[i] == INT64_MIN) {
+            // determine the animation phase shift the first time after starting animation
+            self->anim_phase_shifts[i] = tnow % duration_idle;
+        }
+    }
+    animations_update_batch(self->animations, self->n, self->ianims, self->anim_phase_shifts, tnow,
+                            self->t_frame_expires, self->iframes);
+
+    // integrate the motion of all ducks in one pass, using the fastest kernel this CPU supports
+    const struct physics_bodies bodies = (struct physics_bodies) {
+        .bbox_x = self->bbox.x,
+        .bbox_y = self->bbox.y,
+        .n = self->n,
+        .pos_prev_x = self->pos_prev.x,
+        .pos_prev_y = self->pos_prev.y,
+        .pos_x = self->pos.x,
+        .pos_y = self->pos.y,
+        .vx = self->v.x,
+        .vy = self->v.y,
+    };
+    physics_integrate(&bodies, timings_get_tick_duration(timings), world_get_gravity(world), self->vmax);
+}
+
+void ducks_walk_left (struct ducks * self, int iduck) {
+    self->is_facing_right[iduck] = false;
+    self->v.x[iduck] = -1.0f * self->vwalking;
+    if (self->ianims[iduck] != ANIMATION_STATE_WALKING) {
+        self->ianims[iduck] = ANIMATION_STATE_WALKING;
+        // trigger animations_update_batch() in ducks_update()
+        self->t_frame_expires[iduck] = INT64_MIN;
+    }
+}
+
+void ducks_walk_right (struct ducks * self, int iduck) {
+    self->is_facing_right[iduck] = true;
+    self->v.x[iduck] = self->vwalking;
+    if (self->ianims[iduck] != ANIMATION_STATE_WALKING) {
+        self->ianims[iduck] = ANIMATION_STATE_WALKING;
+        // trigger animations_update_batch() in ducks_update()
+        self->t_frame_expires[iduck] = INT64_MIN;
+    }
+}
@@ -1,21 +1,31 @@
 #include "mbm/background.h"       // struct background and associated functions
 #include "mbm/caption_fps.h"      // struct caption_fps and associated functions
 #include "mbm/caption_paused.h"   // struct caption_paused and associated functions
-#include "mbm/duck.h"             // struct duck and associated functions
+#include "mbm/dims.h"             // struct dims
+#include "mbm/ducks.h"            // struct ducks and associated functions
 #include "mbm/game.h"             // struct game and associated functions
 #include "mbm/timings.h"          // struct timings and associated functions
 #include "mbm/world.h"            // struct world and associated functions
+#include "atlas.h"                // struct atlas and associated functions
+#include "camera.h"               // struct camera and associated functions
+#include "input.h"                // struct input and associated functions, INPUT_BUTTON_*
+#include "loader.h"               // struct loader and associated functions
+#include "profiler.h"             // MBM_PROFILE_SCOPE, MBM_PROFILE_FRAME, MBM_PROFILE_THREAD, profiler_dump
+#include "resources.h"            // struct resources and associated functions
+#include "sprites.h"              // struct sprites and associated functions
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_events.h"      // SDL_Event
 #include "SDL3/SDL_init.h"        // SDL_AppResult
-#include "SDL3/SDL_keyboard.h"    // SDL_GetKeyboardState
 #include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_rect.h"        // SDL_FRect
 #include "SDL3/SDL_render.h"      // SDL_Renderer
-#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc
-#include "SDL3/SDL_video.h"       // SDL_Window
+#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc, SDL_lroundf
+#include "SDL3/SDL_video.h"       // SDL_Window, SDL_DisplayMode, SDL_GetCurrentDisplayMode, SDL_GetDisplayForWindow
+#include <stdint.h>               // uint8_t
 #include <stdlib.h>               // exit
 
 typedef enum {
+    MBM_GAME_STATE_LOADING,
     MBM_GAME_STATE_PLAYING,
     MBM_GAME_STATE_PAUSED,
     MBM_GAME_STATE_LEN,
@@ -23,7 +33,7 @@ typedef enum {
 
 typedef void (*DrawFunction)(const struct game * game, SDL_Renderer * renderer);
 typedef SDL_AppResult (*HandleEventFunction)(struct game * self, SDL_Renderer * renderer, const SDL_Event * event);
-typedef void (*UpdateFunction)(struct game * game, const struct timings * timings);
+typedef void (*UpdateFunction)(struct game * game, struct timings * timings);
 
 struct delegation_functions {
     DrawFunction draw;
@@ -33,11 +43,27 @@ struct delegation_functions {
 
 // declare properties of `struct game`
 struct game {
+    struct atlas * atlas;
     struct background * background;
+    struct camera * camera;                   // follows the player's duck
     struct caption_fps * caption_fps;
     struct caption_paused * caption_paused;
-    struct duck * duck;
     struct delegation_functions delegated_functions[MBM_GAME_STATE_LEN];
+    struct dims dims;
+    struct ducks * ducks;
+    struct input * input;                     // the player's input, live, recorded or replayed
+    bool is_dirty;                            // whether the frame differs from the one presented last
+    bool is_event_pending;                    // whether an event arrived since the last update
+    bool is_rate_stale;                       // whether the timings' target rate needs updating
+    int iplayer;                              // index of the duck that the arrow keys steer
+    struct loader * loader;
+    int nducks_pending;                       // ducks to spawn once loading has finished
+    float progress;                           // fraction of the assets that have been loaded
+    int rate_fixed;                           // frames per second set by game_set_target_rate(), or 0
+    int rate_refresh;                         // the display's refresh rate, paced at while vsync is off
+    SDL_Renderer * renderer;
+    struct resources * resources;             // shared textures and fonts
+    struct sprites * sprites;                 // quads of the current frame
     State state;
     bool vsync_enabled;
     struct world * world;
@@ -47,25 +73,41 @@ struct game {
 static struct game * singleton = nullptr;
 
 // forward function declarations
+static void draw_loading (const struct game * self, SDL_Renderer * renderer);
 static void draw_paused (const struct game * self, SDL_Renderer * renderer);
 static void draw_playing (const struct game * self, SDL_Renderer * renderer);
+static void finish_loading (struct game * self);
+static SDL_AppResult handle_event_loading (struct game * self, SDL_Renderer * renderer, const SDL_Event * event);
 static SDL_AppResult handle_event_paused (struct game * self, SDL_Renderer * renderer, const SDL_Event * event);
 static SDL_AppResult handle_event_playing (struct game * self, SDL_Renderer * renderer, const SDL_Event * event);
 static void pause (struct game * self);
 static void play (struct game * self);
+static void tick_playing (struct game * self, const struct timings * timings);
 static void toggle_vsync (struct game * self, SDL_Renderer * renderer);
-static void update_paused (struct game * self, const struct timings * timings);
-static void update_playing (struct game * self, const struct timings * timings);
+static void update_loading (struct game * self, struct timings * timings);
+static void update_paused (struct game * self, struct timings * timings);
+static void update_playing (struct game * self, struct timings * timings);
 
 
 void game_delete (struct game ** self) {
 
-    // delegate freeing dynamically allocated memory to the respective objects
-    caption_paused_delete(&(*self)->caption_paused);
-    caption_fps_delete(&(*self)->caption_fps);
-    duck_delete(&(*self)->duck);
+    // delegate freeing dynamically allocated memory to the respective objects; the objects
+    // that depend on assets only exist once loading has finished
+    if ((*self)->state != MBM_GAME_STATE_LOADING) {
+        caption_paused_delete(&(*self)->caption_paused);
+        caption_fps_delete(&(*self)->caption_fps);
+        camera_delete(&(*self)->camera);
+        ducks_delete(&(*self)->ducks);
+        world_delete(&(*self)->world);
+        atlas_delete(&(*self)->atlas);
+    }
     background_delete(&(*self)->background);
-    world_delete(&(*self)->world);
+
+    // the objects have handed back their textures and fonts by now
+    resources_delete(&(*self)->resources);
+    loader_delete(&(*self)->loader);
+    sprites_delete(&(*self)->sprites);
+    input_delete(&(*self)->input);
 
     // release own resources
     SDL_free(*self);
@@ -73,29 +115,111 @@ void game_delete (struct game ** self) {
 }
 
 void game_draw (const struct game * self, SDL_Renderer * renderer) {
+    MBM_PROFILE_SCOPE("game_draw");
     self->delegated_functions[self->state].draw(self, renderer);
+
+    // the states only collect their quads; draw them all at once, with as few calls as textures
+    sprites_flush(self->sprites, renderer);
+}
+
+static void draw_loading (const struct game * self, SDL_Renderer * renderer) {
+    background_draw(self->background, renderer);
+
+    // draw a progress bar in the middle of the view
+    const SDL_FRect outline = (SDL_FRect) {
+        .h = 12.0f,
+        .w = self->dims.view.w / 2.0f,
+        .x = self->dims.view.w / 4.0f,
+        .y = self->dims.view.h / 2.0f - 6.0f,
+    };
+    const SDL_FRect bar = (SDL_FRect) {
+        .h = outline.h - 4.0f,
+        .w = (outline.w - 4.0f) * self->progress,
+        .x = outline.x + 2.0f,
+        .y = outline.y + 2.0f,
+    };
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    SDL_RenderRect(renderer, &outline);
+    SDL_RenderFillRect(renderer, &bar);
 }
 
 static void draw_paused (const struct game * self, SDL_Renderer * renderer) {
     background_draw(self->background, renderer);
-    world_draw(self->world, renderer);
-    duck_draw(self->duck, renderer);
-    caption_fps_draw(self->caption_fps, renderer);
-    caption_paused_draw(self->caption_paused, renderer);
+    world_draw(self->world, self->sprites, self->camera);
+    ducks_draw(self->ducks, self->sprites, self->camera);
+    caption_fps_draw(self->caption_fps, self->sprites);
+    caption_paused_draw(self->caption_paused, self->sprites);
 }
 
 static void draw_playing (const struct game * self, SDL_Renderer * renderer) {
     background_draw(self->background, renderer);
-    world_draw(self->world, renderer);
-    duck_draw(self->duck, renderer);
-    caption_fps_draw(self->caption_fps, renderer);
+    world_draw(self->world, self->sprites, self->camera);
+    ducks_draw(self->ducks, self->sprites, self->camera);
+    caption_fps_draw(self->caption_fps, self->sprites);
+}
+
+static void finish_loading (struct game * self) {
+    SDL_Renderer * renderer = self->renderer;
+
+    // initialize the atlas, which holds the sprite sheets of the world and the ducks
+    self->atlas = atlas_new();
+    atlas_init(self->atlas, renderer, self->resources);
+
+    // initialize the world
+    self->world = world_new();
+    world_init(self->world, self->atlas, &self->dims);
+
+    // initialize the ducks, and spawn the player's duck
+    self->ducks = ducks_new();
+    ducks_init(self->ducks, self->atlas, 16);
+    self->iplayer = ducks_spawn(self->ducks, 15 * self->dims.tile.w, 4 * self->dims.tile.h, false);
+
+    // initialize the camera, keeping it inside the level, and line up the tiles and background with it
+    self->camera = camera_new();
+    camera_init(self->camera, &self->dims, world_get_bbox(self->world));
+    camera_follow(self->camera, ducks_get_bbox(self->ducks, self->iplayer));
+    world_update(self->world, self->camera);
+    background_update(self->background, self->camera);
+
+    // initialize the caption_fps
+    self->caption_fps = caption_fps_new();
+    caption_fps_init(self->caption_fps, renderer, self->resources);
+
+    // initialize the caption_paused
+    self->caption_paused = caption_paused_new();
+    caption_paused_init(self->caption_paused, renderer, self->resources, &self->dims);
+
+    play(self);
+    game_spawn_ducks(self, self->nducks_pending);
+    self->nducks_pending = 0;
 }
 
 SDL_AppResult game_handle_event (struct game * self, SDL_Renderer * renderer, const SDL_Event * event) {
     return self->delegated_functions[self->state].handle_event(self, renderer, event);
 }
 
+static SDL_AppResult handle_event_loading (struct game * self, SDL_Renderer * renderer, const SDL_Event * event) {
+    input_handle_event(self->input, event);
+    switch (event->type) {
+    case SDL_EVENT_QUIT:
+        return SDL_APP_SUCCESS;
+    case SDL_EVENT_KEY_DOWN:
+        switch (event->key.key) {
+        case SDLK_Q:
+            return SDL_APP_SUCCESS;
+        case SDLK_V:
+            toggle_vsync(self, renderer);
+            break;
+        }
+    }
+    return SDL_APP_CONTINUE;
+}
+
 static SDL_AppResult handle_event_paused (struct game * self, SDL_Renderer * renderer, const SDL_Event * event) {
+    // any event may change what the paused frame looks like, be it a key or e.g. the window
+    // being exposed or resized, so redraw on the next update
+    self->is_event_pending = true;
+    input_handle_event(self->input, event);
     switch (event->type) {
     case SDL_EVENT_QUIT:
         return SDL_APP_SUCCESS;
@@ -109,6 +233,15 @@ static SDL_AppResult handle_event_paused (struct game * self, SDL_Renderer * ren
         case SDLK_F:
             caption_fps_toggle(self->caption_fps);
             break;
+        case SDLK_G:
+            caption_fps_toggle_graph(self->caption_fps);
+            break;
+        case SDLK_P:
+            profiler_dump("mbm-trace.json", 300);
+            break;
+        case SDLK_R:
+            resources_log(self->resources);
+            break;
         case SDLK_V:
             toggle_vsync(self, renderer);
             break;
@@ -118,6 +251,7 @@ static SDL_AppResult handle_event_paused (struct game * self, SDL_Renderer * ren
 }
 
 static SDL_AppResult handle_event_playing (struct game * self, SDL_Renderer * renderer, const SDL_Event * event) {
+    input_handle_event(self->input, event);
     switch (event->type) {
     case SDL_EVENT_QUIT:
         return SDL_APP_SUCCESS;
@@ -127,11 +261,20 @@ static SDL_AppResult handle_event_playing (struct game * self, SDL_Renderer * re
             pause(self);
             break;
         case SDLK_SPACE:
-            duck_jump(self->duck);
+            input_jump(self->input);
             break;
         case SDLK_F:
             caption_fps_toggle(self->caption_fps);
             break;
+        case SDLK_G:
+            caption_fps_toggle_graph(self->caption_fps);
+            break;
+        case SDLK_P:
+            profiler_dump("mbm-trace.json", 300);
+            break;
+        case SDLK_R:
+            resources_log(self->resources);
+            break;
         case SDLK_V:
             toggle_vsync(self, renderer);
             break;
@@ -145,6 +288,16 @@ void game_init (struct game * self, SDL_Renderer * renderer, const struct dims *
     // empty-initialize the singleton instance of `struct game`
     *self = (struct game) {};
 
+    // the game's scopes are all recorded on this thread, so set up its profiler ring here
+    MBM_PROFILE_THREAD();
+
+    // initialize the state-based indirection to static functions for game state 'loading'
+    self->delegated_functions[MBM_GAME_STATE_LOADING] = (struct delegation_functions){
+        .draw = draw_loading,
+        .handle_event = handle_event_loading,
+        .update = update_loading,
+    };
+
     // initialize the state-based indirection to static functions for game state 'paused'
     self->delegated_functions[MBM_GAME_STATE_PAUSED] = (struct delegation_functions){
         .draw = draw_paused,
@@ -159,32 +312,54 @@ void game_init (struct game * self, SDL_Renderer * renderer, const struct dims *
         .update = update_playing,
     };
 
-    // initialize the gamestate
-    self->state = MBM_GAME_STATE_PLAYING;
+    // initialize the gamestate; the game plays once its assets have loaded
+    self->state = MBM_GAME_STATE_LOADING;
+
+    // pace frames at the display's refresh rate while vsync is off, such that the loop doesn't
+    // spin through frames that the display never shows; assume 60 Hz if the rate is unknown
+    const SDL_DisplayMode * mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(SDL_GetRenderWindow(renderer)));
+    self->rate_refresh = mode != nullptr && mode->refresh_rate > 0.0f ? (int) SDL_lroundf(mode->refresh_rate) : 60;
 
     // initialize vsync to false, then toggle it
     self->vsync_enabled = false;
     toggle_vsync(self, renderer);
 
-    // initialize the background
+    // initialize the background, which is drawn while loading already
     self->background = background_new();
-    background_init(self->background);
-
-    // initialize the world
-    self->world = world_new();
-    world_init(self->world, renderer, dims);
+    background_init(self->background, renderer, dims);
+
+    // initialize the sprite batch that the objects draw into
+    self->sprites = sprites_new();
+    sprites_init(self->sprites);
+
+    // initialize the input, which is live unless game_record_input() or game_replay_input() say otherwise
+    self->input = input_new();
+    input_init(self->input);
+
+    // decode the assets on worker threads; the objects that use them are initialized by
+    // finish_loading(), on this thread, because that's where textures need to be created
+    self->dims = *dims;
+    self->renderer = renderer;
+    self->loader = loader_new();
+    loader_enqueue_surface(self->loader, "../share/mbm/assets/images/atlas.bmp");
+    loader_enqueue_font(self->loader, "../share/mbm/assets/fonts/JetBrainsMono-SemiBold.ttf", 48.0f);
+    loader_start(self->loader);
+
+    // whatever the loader decoded is turned into shared textures and fonts on first use
+    self->resources = resources_new();
+    resources_init(self->resources, self->loader);
+}
 
-    // initialize the duck
-    self->duck = duck_new();
-    duck_init(self->duck, renderer, dims);
+bool game_is_dirty (const struct game * self) {
+    return self->is_dirty;
+}
 
-    // initialize the caption_fps
-    self->caption_fps = caption_fps_new();
-    caption_fps_init(self->caption_fps);
+bool game_is_loading (const struct game * self) {
+    return self->state == MBM_GAME_STATE_LOADING;
+}
 
-    // initialize the caption_paused
-    self->caption_paused = caption_paused_new();
-    caption_paused_init(self->caption_paused, renderer, dims);
+bool game_is_replay_done (const struct game * self) {
+    return input_is_replay_done(self->input);
 }
 
 struct game * game_new (void) {
@@ -202,40 +377,129 @@ struct game * game_new (void) {
     return singleton;
 }
 
-void game_update (struct game * self, const struct timings * timings) {
+void game_record_input (struct game * self, const char * path) {
+    input_record(self->input, path);
+}
+
+void game_replay_input (struct game * self, const char * path) {
+    input_replay(self->input, path);
+}
+
+void game_set_target_rate (struct game * self, SDL_Renderer * renderer, int rate) {
+    // pacing at a fixed rate on top of vsync would make the two schedules clash, so vsync stays
+    // off for as long as the rate is fixed
+    self->rate_fixed = rate;
+    self->vsync_enabled = rate == 0;
+    self->is_rate_stale = true;
+    SDL_SetRenderVSync(renderer, self->vsync_enabled ? SDL_RENDERER_VSYNC_ADAPTIVE : SDL_RENDERER_VSYNC_DISABLED);
+}
+
+void game_spawn_ducks (struct game * self, int nducks) {
+    if (self->state == MBM_GAME_STATE_LOADING) {
+        // the ducks don't exist until their assets have loaded
+        self->nducks_pending += nducks;
+        return;
+    }
+
+    // spread the wandering ducks over the level in a fixed pattern, such that every run
+    // starts from the same state; keep them out of the walls in the first and last column
+    const SDL_FRect bbox = world_get_bbox(self->world);
+    const int ncols = (int) bbox.w / self->dims.tile.w;
+    const int nrows = (int) bbox.h / self->dims.tile.h;
+    for (int i = 0; i < nducks; i++) {
+        const int icol = 1 + (i * 7) % (ncols - 3);
+        const int irow = (i * 3) % (nrows - 4);
+        ducks_spawn(self->ducks, icol * self->dims.tile.w, irow * self->dims.tile.h, true);
+    }
+}
+
+void game_update (struct game * self, struct timings * timings) {
+    MBM_PROFILE_FRAME();
+    MBM_PROFILE_SCOPE("game_update");
+    if (self->is_rate_stale) {
+        // vsync paces frames by itself; otherwise, pace them at the fixed rate if there is one,
+        // or else at the display's refresh rate
+        const int rate = self->rate_fixed > 0 ? self->rate_fixed : self->rate_refresh;
+        timings_set_target_rate(timings, self->vsync_enabled ? 0 : rate);
+        self->is_rate_stale = false;
+    }
     self->delegated_functions[self->state].update(self, timings);
 }
 
 static void pause (struct game * self) {
     self->state = MBM_GAME_STATE_PAUSED;
+    self->is_event_pending = true;
 }
 
 static void play (struct game * self) {
     self->state = MBM_GAME_STATE_PLAYING;
 }
 
+static void tick_playing (struct game * self, const struct timings * timings) {
+    // steer the player's duck with the input for this tick, which is the same whether it's live
+    // or replayed
+    const uint8_t buttons = input_tick(self->input, timings);
+    ducks_halt(self->ducks, self->iplayer);
+    if (buttons & INPUT_BUTTON_LEFT) {
+        ducks_walk_left(self->ducks, self->iplayer);
+    }
+    if (buttons & INPUT_BUTTON_RIGHT) {
+        ducks_walk_right(self->ducks, self->iplayer);
+    }
+    if (buttons & INPUT_BUTTON_JUMP) {
+        ducks_jump(self->ducks, self->iplayer);
+    }
+    ducks_update(self->ducks, self->world, timings);
+
+    ducks_handle_collision_with_world(self->ducks, self->world);
+}
+
 static void toggle_vsync (struct game * self, SDL_Renderer * renderer) {
+    if (self->rate_fixed > 0) {
+        // the frames are paced at a fixed rate, which vsync would clash with
+        return;
+    }
     self->vsync_enabled = !self->vsync_enabled;
+    self->is_rate_stale = true;
     SDL_SetRenderVSync(renderer, self->vsync_enabled ? SDL_RENDERER_VSYNC_ADAPTIVE : SDL_RENDERER_VSYNC_DISABLED);
 }
 
-static void update_paused (struct game * self, const struct timings * timings) {
-    caption_fps_update(self->caption_fps, timings);
+static void update_loading (struct game * self, struct timings * timings) {
+    // keep the simulation clock in step with the wall clock, but don't simulate anything
+    while (timings_tick(timings)) {}
+    self->is_dirty = true;
+    self->progress = loader_get_progress(self->loader);
+    if (loader_is_done(self->loader)) {
+        finish_loading(self);
+    }
 }
 
-static void update_playing (struct game * self, const struct timings * timings) {
-    duck_halt(self->duck);
-    const bool * key_states = SDL_GetKeyboardState(nullptr);
-    if (key_states[SDL_SCANCODE_LEFT]) {
-        duck_walk_left(self->duck);
-    }
-    if (key_states[SDL_SCANCODE_RIGHT]) {
-        duck_walk_right(self->duck);
+static void update_paused (struct game * self, struct timings * timings) {
+    // keep the simulation clock in step with the wall clock, but don't simulate anything
+    while (timings_tick(timings)) {}
+
+    // the paused scene is static, apart from whatever the events changed; the frame rate caption
+    // keeps the numbers from before the pause, since paused frames mostly wait for events
+    self->is_dirty = self->is_event_pending;
+    self->is_event_pending = false;
+}
+
+static void update_playing (struct game * self, struct timings * timings) {
+    // advance the simulation in fixed steps, as many as have accumulated since the last frame
+    while (timings_tick(timings)) {
+        tick_playing(self, timings);
     }
-    background_update(self->background, timings);
-    world_update(self->world, timings);
-    duck_update(self->duck, self->world, timings);
-    caption_fps_update(self->caption_fps, timings);
 
-    duck_handle_collision_with_world(self->duck, self->world);
+    // place the ducks between their last two simulated states, according to the leftover time
+    ducks_interpolate(self->ducks, timings_get_tick_alpha(timings));
+
+    // the camera follows the player's duck where it's drawn rather than where it was simulated,
+    // such that the duck doesn't jitter relative to the view; the world then catches up with the
+    // tile columns that scrolled into view, and the background layers with their offsets
+    camera_follow(self->camera, ducks_get_bbox(self->ducks, self->iplayer));
+    world_update(self->world, self->camera);
+    background_update(self->background, self->camera);
+
+    caption_fps_update(self->caption_fps, timings, self->sprites);
+    self->is_dirty = true;
 }
@@ -0,0 +1,261 @@
+#include "input.h"
+#include "mbm/timings.h"          // struct timings, timings_get_tick_duration
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_events.h"      // SDL_Event, SDL_EVENT_*
+#include "SDL3/SDL_iostream.h"    // SDL_IOStream, SDL_IOFromFile, SDL_WriteIO, SDL_CloseIO, SDL_LoadFile
+#include "SDL3/SDL_keycode.h"     // SDLK_LEFT, SDLK_RIGHT
+#include "SDL3/SDL_log.h"         // SDL_Log, SDL_LogCritical
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_free, SDL_memcmp, SDL_memcpy, SDL_realloc
+#include <stdint.h>               // uint8_t, uint32_t
+#include <stdlib.h>               // exit
+
+// Layout of input files: a header, followed by `nrecords` records in order of tick. A record
+// holds the buttons from its tick onwards, until the tick of the next record, so a file only grows
+// when the input changes. Numbers are stored in the byte order of the machine that recorded them.
+#define INPUT_MAGIC "MBMI"
+#define INPUT_VERSION 1
+
+struct input_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t tick_duration;                   // microseconds, which replaying has to match
+    uint32_t nrecords;
+    uint32_t nticks;                          // length of the recording
+};
+
+struct input_record {
+    uint32_t itick;                           // ticks since the start of the recording
+    uint8_t buttons;                          // enum input_button flags
+    uint8_t padding[3];
+};
+
+enum input_mode: uint8_t {
+    INPUT_MODE_LIVE = 0,
+    INPUT_MODE_RECORDING,
+    INPUT_MODE_REPLAYING,
+};
+
+// declare properties of `struct input`
+struct input {
+    uint8_t buttons_live;                     // held buttons, plus a jump that waits for the next tick
+    uint8_t buttons_replayed;                 // buttons of the last record that was replayed
+    int irecord;                              // next record to replay
+    int itick;                                // ticks since recording or replaying started
+    enum input_mode mode;
+    int nrecords;
+    int nrecords_cap;
+    int nticks;                               // length of the recording that is replayed
+    char * path;                              // where the recording goes
+    struct input_record * records;
+    uint32_t tick_duration;                   // microseconds, as of the first tick
+    uint32_t tick_duration_replayed;          // microseconds, as recorded
+};
+
+// define pointer to singleton instance of `struct input`
+static struct input * singleton = nullptr;
+
+// forward declaration of static functions
+static void append (struct input * self, uint8_t buttons);
+static void save (const struct input * self);
+
+static void append (struct input * self, uint8_t buttons) {
+    if (self->nrecords == self->nrecords_cap) {
+        const int nrecords_cap = self->nrecords_cap > 0 ? 2 * self->nrecords_cap : 256;
+        struct input_record * records = SDL_realloc(self->records, nrecords_cap * sizeof(struct input_record));
+        if (records == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "ERROR allocating dynamic memory for input records, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+        self->records = records;
+        self->nrecords_cap = nrecords_cap;
+    }
+    self->records[self->nrecords] = (struct input_record) {
+        .itick = (uint32_t) self->itick,
+        .buttons = buttons,
+    };
+    self->nrecords++;
+}
+
+static void save (const struct input * self) {
+    const struct input_header header = {
+        .magic = { INPUT_MAGIC[0], INPUT_MAGIC[1], INPUT_MAGIC[2], INPUT_MAGIC[3] },
+        .version = INPUT_VERSION,
+        .tick_duration = self->tick_duration,
+        .nrecords = (uint32_t) self->nrecords,
+        .nticks = (uint32_t) self->itick,
+    };
+    const size_t nbytes = self->nrecords * sizeof(struct input_record);
+    SDL_IOStream * stream = SDL_IOFromFile(self->path, "wb");
+    if (stream == nullptr ||
+        SDL_WriteIO(stream, &header, sizeof(struct input_header)) != sizeof(struct input_header) ||
+        SDL_WriteIO(stream, self->records, nbytes) != nbytes) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't write input recording to '%s'; %s\n",
+                        self->path, SDL_GetError());
+    }
+    if (stream != nullptr) {
+        SDL_CloseIO(stream);
+    }
+    SDL_Log("input: recorded %d ticks in %d records to '%s'\n", self->itick, self->nrecords, self->path);
+}
+
+void input_delete (struct input ** self) {
+    if ((*self)->mode == INPUT_MODE_RECORDING) {
+        save(*self);
+    }
+    SDL_free((*self)->path);
+    (*self)->path = nullptr;
+    SDL_free((*self)->records);
+    (*self)->records = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+    singleton = nullptr;
+}
+
+void input_handle_event (struct input * self, const SDL_Event * event) {
+    // follow the arrow keys through their key events rather than by polling the keyboard state,
+    // such that synthesized events (e.g. from a benchmark script) steer the duck too
+    switch (event->type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        if (event->key.key == SDLK_LEFT) {
+            self->buttons_live = event->key.down ? self->buttons_live | INPUT_BUTTON_LEFT :
+                                                   self->buttons_live & ~INPUT_BUTTON_LEFT;
+        }
+        if (event->key.key == SDLK_RIGHT) {
+            self->buttons_live = event->key.down ? self->buttons_live | INPUT_BUTTON_RIGHT :
+                                                   self->buttons_live & ~INPUT_BUTTON_RIGHT;
+        }
+        break;
+    case SDL_EVENT_WINDOW_FOCUS_LOST:
+        // key up events go elsewhere while the window doesn't have focus
+        self->buttons_live &= ~(INPUT_BUTTON_LEFT | INPUT_BUTTON_RIGHT);
+        break;
+    }
+}
+
+void input_init (struct input * self) {
+    *self = (struct input) {
+        .buttons_live = 0,
+        .buttons_replayed = 0,
+        .irecord = 0,
+        .itick = 0,
+        .mode = INPUT_MODE_LIVE,
+        .nrecords = 0,
+        .nrecords_cap = 0,
+        .nticks = 0,
+        .path = nullptr,
+        .records = nullptr,
+        .tick_duration = 0,
+        .tick_duration_replayed = 0,
+    };
+}
+
+bool input_is_replay_done (const struct input * self) {
+    return self->mode == INPUT_MODE_REPLAYING && self->itick >= self->nticks;
+}
+
+void input_jump (struct input * self) {
+    self->buttons_live |= INPUT_BUTTON_JUMP;
+}
+
+struct input * input_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct input *) SDL_calloc(1, sizeof(struct input));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct input, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
+
+void input_record (struct input * self, const char * path) {
+    // the recording is kept in memory, and written to `path` by input_delete()
+    SDL_asprintf(&self->path, "%s", path);
+    self->mode = INPUT_MODE_RECORDING;
+}
+
+void input_replay (struct input * self, const char * path) {
+
+    // the whole recording is small enough to read in one go
+    size_t size = 0;
+    uint8_t * bytes = SDL_LoadFile(path, &size);
+    if (bytes == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't read input recording, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+
+    // check the header before trusting the number of records in it
+    struct input_header header = {};
+    const bool is_complete = size >= sizeof(struct input_header);
+    if (is_complete) {
+        SDL_memcpy(&header, bytes, sizeof(struct input_header));
+    }
+    const bool is_valid = is_complete &&
+                          SDL_memcmp(header.magic, INPUT_MAGIC, 4) == 0 &&
+                          header.version == INPUT_VERSION &&
+                          sizeof(struct input_header) + header.nrecords * sizeof(struct input_record) == size;
+    if (!is_valid) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Input recording '%s' is invalid or was made by another version, aborting.\n", path);
+        exit(1);
+    }
+
+    self->records = SDL_calloc(header.nrecords > 0 ? header.nrecords : 1, sizeof(struct input_record));
+    if (self->records == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for input records, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    SDL_memcpy(self->records, &bytes[sizeof(struct input_header)], header.nrecords * sizeof(struct input_record));
+    SDL_free(bytes);
+    bytes = nullptr;
+
+    self->mode = INPUT_MODE_REPLAYING;
+    self->nrecords = (int) header.nrecords;
+    self->nrecords_cap = (int) header.nrecords;
+    self->nticks = (int) header.nticks;
+    self->tick_duration_replayed = header.tick_duration;
+}
+
+uint8_t input_tick (struct input * self, const struct timings * timings) {
+    if (self->itick == 0) {
+        self->tick_duration = (uint32_t) (timings_get_tick_duration(timings) * 1e6f + 0.5f);
+        if (self->mode == INPUT_MODE_REPLAYING && self->tick_duration != self->tick_duration_replayed) {
+            // the same input at another tick rate doesn't reproduce the same simulation
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Input recording was made with ticks of %u us rather than %u us, aborting.\n",
+                            self->tick_duration_replayed, self->tick_duration);
+            exit(1);
+        }
+    }
+    uint8_t buttons = 0;
+    if (self->mode == INPUT_MODE_REPLAYING) {
+        // ignore the live input, and take the buttons from the recording instead
+        while (self->irecord < self->nrecords && self->records[self->irecord].itick <= (uint32_t) self->itick) {
+            self->buttons_replayed = self->records[self->irecord].buttons;
+            self->irecord++;
+        }
+        buttons = self->itick < self->nticks ? self->buttons_replayed : 0;
+    } else {
+        // a jump counts for one tick only
+        buttons = self->buttons_live;
+        self->buttons_live &= ~INPUT_BUTTON_JUMP;
+        const bool is_changed = self->nrecords == 0 || self->records[self->nrecords - 1].buttons != buttons;
+        if (self->mode == INPUT_MODE_RECORDING && is_changed) {
+            append(self, buttons);
+        }
+    }
+    self->itick++;
+    return buttons;
+}
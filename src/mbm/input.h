@@ -0,0 +1,29 @@
+#ifndef MBM_INPUT_H_INCLUDED
+#define MBM_INPUT_H_INCLUDED
+#include "mbm/abi.h"
+#include "mbm/timings.h"          // struct timings and associated functions
+#include "SDL3/SDL_events.h"      // SDL_Event
+#include <stdint.h>               // uint8_t
+
+// what the player asks of their duck during one simulation tick, as a set of flags
+enum input_button: uint8_t {
+    INPUT_BUTTON_LEFT = 1 << 0,               // held
+    INPUT_BUTTON_RIGHT = 1 << 1,              // held
+    INPUT_BUTTON_JUMP = 1 << 2,               // pressed since the previous tick
+};
+
+// `struct input` is an opaque data structure;
+// only the implementation has access to its layout
+struct input;
+
+MBM_NO_ABI void input_delete (struct input ** self);
+MBM_NO_ABI void input_handle_event (struct input * self, const SDL_Event * event);
+MBM_NO_ABI void input_init (struct input * self);
+MBM_NO_ABI bool input_is_replay_done (const struct input * self);
+MBM_NO_ABI void input_jump (struct input * self);
+MBM_NO_ABI struct input * input_new (void);
+MBM_NO_ABI void input_record (struct input * self, const char * path);
+MBM_NO_ABI void input_replay (struct input * self, const char * path);
+MBM_NO_ABI uint8_t input_tick (struct input * self, const struct timings * timings);
+
+#endif
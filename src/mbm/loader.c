@@ -0,0 +1,288 @@
+#include "loader.h"
+#include "SDL3/SDL_atomic.h"      // SDL_AtomicInt, SDL_AddAtomicInt, SDL_GetAtomicInt, SDL_SetAtomicInt
+#include "SDL3/SDL_cpuinfo.h"     // SDL_GetNumLogicalCPUCores
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_filesystem.h"  // SDL_GetBasePath
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_mutex.h"       // SDL_Mutex, SDL_CreateMutex, SDL_DestroyMutex, SDL_LockMutex, SDL_UnlockMutex
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_CreateTextureFromSurface
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_free, SDL_max, SDL_min, SDL_strcmp, SDL_strlcpy
+#include "SDL3/SDL_surface.h"     // SDL_Surface, SDL_LoadBMP, SDL_DestroySurface
+#include "SDL3/SDL_thread.h"      // SDL_Thread, SDL_CreateThread, SDL_WaitThread
+#include <SDL3_ttf/SDL_ttf.h>     // TTF_Font, TTF_OpenFont, TTF_CloseFont, TTF_SetFontSize
+#include <stdlib.h>               // exit
+
+// upper limits on the number of files per loader and on the number of threads decoding them
+#define LOADER_NJOBS_MAX 32
+#define LOADER_NTHREADS_MAX 4
+
+enum job_kind: uint8_t {
+    JOB_KIND_FONT = 0,
+    JOB_KIND_SURFACE,
+};
+
+struct job {
+    SDL_AtomicInt done;                       // set by the worker that ran the job
+    char error[128];                          // copy of SDL_GetError() on the worker, if decoding failed
+    TTF_Font * font;
+    bool is_taken;                            // whether ownership of the result has moved to the caller
+    enum job_kind kind;
+    float ptsize;
+    char * relpath;
+    SDL_Surface * surface;
+};
+
+// declare properties of `struct loader`
+struct loader {
+    SDL_Mutex * font_mutex;                   // opening fonts is not safe to do concurrently
+    SDL_AtomicInt inext;                      // index of the next job that a worker should claim
+    struct job jobs[LOADER_NJOBS_MAX];
+    SDL_AtomicInt ndone;
+    int njobs;
+    int nthreads;
+    SDL_Thread * threads[LOADER_NTHREADS_MAX];
+};
+
+// forward declaration of static functions
+static void enqueue (struct loader * self, enum job_kind kind, const char * relpath, float ptsize);
+static struct job * find (struct loader * self, enum job_kind kind, const char * relpath);
+static void run (struct loader * self, struct job * job);
+static void wait_for_threads (struct loader * self);
+static int work (void * data);
+
+// define pointer to singleton instance of `struct loader`
+static struct loader * singleton = nullptr;
+
+static void enqueue (struct loader * self, enum job_kind kind, const char * relpath, float ptsize) {
+    if (self->nthreads > 0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Can't enqueue files after the loader has started, aborting.\n");
+        exit(1);
+    }
+    if (self->njobs >= LOADER_NJOBS_MAX) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Too many files for the loader, aborting.\n");
+        exit(1);
+    }
+    struct job * job = &self->jobs[self->njobs];
+    *job = (struct job) {
+        .kind = kind,
+        .ptsize = ptsize,
+    };
+    SDL_asprintf(&job->relpath, "%s", relpath);
+    self->njobs++;
+}
+
+static struct job * find (struct loader * self, enum job_kind kind, const char * relpath) {
+    if (self->nthreads == 0) {
+        // not started, so nothing has been decoded ahead of time
+        return nullptr;
+    }
+    for (int i = 0; i < self->njobs; i++) {
+        struct job * job = &self->jobs[i];
+        if (job->kind != kind || job->is_taken) continue;
+        if (SDL_strcmp(job->relpath, relpath) != 0) continue;
+        if (SDL_GetAtomicInt(&job->done) == 0) {
+            // asked for before the workers got to it; let them finish rather than decoding twice
+            wait_for_threads(self);
+        }
+        return job;
+    }
+    return nullptr;
+}
+
+static void run (struct loader * self, struct job * job) {
+    char * path = nullptr;
+    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), job->relpath);
+    switch (job->kind) {
+    case JOB_KIND_FONT:
+        SDL_LockMutex(self->font_mutex);
+        job->font = TTF_OpenFont(path, job->ptsize);
+        SDL_UnlockMutex(self->font_mutex);
+        break;
+    case JOB_KIND_SURFACE:
+        job->surface = SDL_LoadBMP(path);
+        break;
+    }
+    if (job->font == nullptr && job->surface == nullptr) {
+        SDL_strlcpy(job->error, SDL_GetError(), sizeof(job->error));
+    }
+    SDL_free(path);
+    path = nullptr;
+}
+
+static void wait_for_threads (struct loader * self) {
+    for (int i = 0; i < self->nthreads; i++) {
+        if (self->threads[i] == nullptr) continue;
+        SDL_WaitThread(self->threads[i], nullptr);
+        self->threads[i] = nullptr;
+    }
+}
+
+static int work (void * data) {
+    struct loader * self = (struct loader *) data;
+    for (;;) {
+        const int i = SDL_AddAtomicInt(&self->inext, 1);
+        if (i >= self->njobs) break;
+        run(self, &self->jobs[i]);
+        SDL_SetAtomicInt(&self->jobs[i].done, 1);
+        SDL_AddAtomicInt(&self->ndone, 1);
+    }
+    return 0;
+}
+
+SDL_Texture * loader_create_texture (struct loader * self, const char * relpath, SDL_Renderer * renderer) {
+
+    // take the surface that a worker decoded, or decode it here if it wasn't enqueued
+    SDL_Surface * surface = nullptr;
+    struct job * job = find(self, JOB_KIND_SURFACE, relpath);
+    if (job != nullptr) {
+        surface = job->surface;
+        job->surface = nullptr;
+        job->is_taken = true;
+        if (surface == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Couldn't load surface from '%s', aborting; %s\n",
+                            relpath, job->error);
+            exit(1);
+        }
+    } else {
+        char * path = nullptr;
+        SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
+        surface = SDL_LoadBMP(path);
+        if (surface == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Couldn't load surface from '%s', aborting; %s\n",
+                            relpath, SDL_GetError());
+            exit(1);
+        }
+        SDL_free(path);
+        path = nullptr;
+    }
+
+    // textures belong to the renderer's thread, so the upload happens here rather than on a worker
+    SDL_Texture * texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't create texture from '%s', aborting; %s\n",
+                        relpath, SDL_GetError());
+        exit(1);
+    }
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+
+    // free dynamically allocated memory used by surface
+    SDL_DestroySurface(surface);
+    surface = nullptr;
+
+    return texture;
+}
+
+void loader_delete (struct loader ** self) {
+    wait_for_threads(*self);
+    for (int i = 0; i < (*self)->njobs; i++) {
+        // release whatever was decoded but never asked for
+        struct job * job = &(*self)->jobs[i];
+        if (job->font != nullptr) {
+            TTF_CloseFont(job->font);
+            job->font = nullptr;
+        }
+        SDL_DestroySurface(job->surface);
+        job->surface = nullptr;
+        SDL_free(job->relpath);
+        job->relpath = nullptr;
+    }
+    SDL_DestroyMutex((*self)->font_mutex);
+    (*self)->font_mutex = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+    singleton = nullptr;
+}
+
+void loader_enqueue_font (struct loader * self, const char * relpath, float ptsize) {
+    enqueue(self, JOB_KIND_FONT, relpath, ptsize);
+}
+
+void loader_enqueue_surface (struct loader * self, const char * relpath) {
+    enqueue(self, JOB_KIND_SURFACE, relpath, 0.0f);
+}
+
+float loader_get_progress (struct loader * self) {
+    if (self->njobs == 0) return 1.0f;
+    return (float) SDL_GetAtomicInt(&self->ndone) / (float) self->njobs;
+}
+
+bool loader_is_done (struct loader * self) {
+    return SDL_GetAtomicInt(&self->ndone) == self->njobs;
+}
+
+struct loader * loader_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct loader *) SDL_calloc(1, sizeof(struct loader));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct loader, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    singleton->font_mutex = SDL_CreateMutex();
+    if (singleton->font_mutex == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR creating mutex for loading fonts, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
+
+TTF_Font * loader_open_font (struct loader * self, const char * relpath, float ptsize) {
+
+    // take the font that a worker opened, or open it here if it wasn't enqueued
+    struct job * job = find(self, JOB_KIND_FONT, relpath);
+    if (job != nullptr) {
+        TTF_Font * font = job->font;
+        job->font = nullptr;
+        job->is_taken = true;
+        if (font == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Couldn't load font from '%s', aborting; %s\n",
+                            relpath, job->error);
+            exit(1);
+        }
+        if (job->ptsize != ptsize) {
+            // fonts are matched by path only, since one open font can serve any size
+            TTF_SetFontSize(font, ptsize);
+        }
+        return font;
+    }
+    char * path = nullptr;
+    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
+    TTF_Font * font = TTF_OpenFont(path, ptsize);
+    if (font == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't load font from '%s', aborting; %s\n",
+                        relpath, SDL_GetError());
+        exit(1);
+    }
+    SDL_free(path);
+    path = nullptr;
+    return font;
+}
+
+void loader_start (struct loader * self) {
+    // one thread per job at most, the rest of the CPUs are left for the main thread
+    const int ncores = SDL_GetNumLogicalCPUCores();
+    const int nthreads = SDL_max(1, SDL_min(SDL_min(ncores - 1, self->njobs), LOADER_NTHREADS_MAX));
+    self->nthreads = nthreads;
+    for (int i = 0; i < nthreads; i++) {
+        self->threads[i] = SDL_CreateThread(work, "loader", self);
+        if (self->threads[i] == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "ERROR creating loader thread, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef MBM_LOADER_H_INCLUDED
+#define MBM_LOADER_H_INCLUDED
+#include "mbm/abi.h"
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture
+#include <SDL3_ttf/SDL_ttf.h>     // TTF_Font
+
+// `struct loader` is an opaque data structure;
+// only the implementation has access to its layout
+struct loader;
+
+MBM_NO_ABI SDL_Texture * loader_create_texture (struct loader * self, const char * relpath, SDL_Renderer * renderer);
+MBM_NO_ABI void loader_delete (struct loader ** self);
+MBM_NO_ABI void loader_enqueue_font (struct loader * self, const char * relpath, float ptsize);
+MBM_NO_ABI void loader_enqueue_surface (struct loader * self, const char * relpath);
+MBM_NO_ABI float loader_get_progress (struct loader * self);
+MBM_NO_ABI bool loader_is_done (struct loader * self);
+MBM_NO_ABI struct loader * loader_new (void);
+MBM_NO_ABI TTF_Font * loader_open_font (struct loader * self, const char * relpath, float ptsize);
+MBM_NO_ABI void loader_start (struct loader * self);
+
+#endif
@@ -0,0 +1,135 @@
+#include "physics.h"
+#include "SDL3/SDL_cpuinfo.h"     // SDL_HasAVX2, SDL_HasSSE2
+#include "SDL3/SDL_stdinc.h"      // SDL_max, SDL_min
+#if defined(__x86_64__) || defined(__i386__)
+#define PHYSICS_HAS_X86_KERNELS
+#include <immintrin.h>            // _mm_*, _mm256_*
+#endif
+
+typedef void (*Kernel)(const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax);
+
+// forward declaration of static functions
+#ifdef PHYSICS_HAS_X86_KERNELS
+static void integrate_avx2 (const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax);
+static void integrate_sse2 (const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax);
+#endif
+static void integrate_scalar (const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax);
+
+// the kernels' entry points, in the order of `enum physics_kernel`
+static const Kernel kernels[PHYSICS_KERNEL_COUNT] = {
+    integrate_scalar,
+#ifdef PHYSICS_HAS_X86_KERNELS
+    integrate_sse2,
+    integrate_avx2,
+#else
+    integrate_scalar,
+    integrate_scalar,
+#endif
+};
+
+#ifdef PHYSICS_HAS_X86_KERNELS
+[[gnu::target("avx2")]]
+static void integrate_avx2 (const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax) {
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vdvy = _mm256_set1_ps(dvy);
+    const __m256 vhi = _mm256_set1_ps(vmax);
+    const __m256 vlo = _mm256_set1_ps(-1 * vmax);
+    int i = ibegin;
+    for (; i + 8 <= bodies->n; i += 8) {
+        const __m256 vy = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_loadu_ps(&bodies->vy[i]), vdvy), vlo), vhi);
+        const __m256 dx = _mm256_mul_ps(_mm256_loadu_ps(&bodies->vx[i]), vdt);
+        const __m256 dy = _mm256_mul_ps(vy, vdt);
+        const __m256 pos_x = _mm256_loadu_ps(&bodies->pos_x[i]);
+        const __m256 pos_y = _mm256_loadu_ps(&bodies->pos_y[i]);
+        _mm256_storeu_ps(&bodies->vy[i], vy);
+        _mm256_storeu_ps(&bodies->pos_prev_x[i], pos_x);
+        _mm256_storeu_ps(&bodies->pos_prev_y[i], pos_y);
+        _mm256_storeu_ps(&bodies->pos_x[i], _mm256_add_ps(pos_x, dx));
+        _mm256_storeu_ps(&bodies->pos_y[i], _mm256_add_ps(pos_y, dy));
+        _mm256_storeu_ps(&bodies->bbox_x[i], _mm256_add_ps(_mm256_loadu_ps(&bodies->bbox_x[i]), dx));
+        _mm256_storeu_ps(&bodies->bbox_y[i], _mm256_add_ps(_mm256_loadu_ps(&bodies->bbox_y[i]), dy));
+    }
+    // the remaining bodies don't fill a vector
+    integrate_scalar(bodies, i, dt, dvy, vmax);
+}
+#endif
+
+static void integrate_scalar (const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax) {
+    for (int i = ibegin; i < bodies->n; i++) {
+        // same order of operations as the vector kernels, such that all kernels agree to the bit
+        const float vy = SDL_min(SDL_max(bodies->vy[i] + dvy, -1 * vmax), vmax);
+        const float dx = bodies->vx[i] * dt;
+        const float dy = vy * dt;
+        bodies->vy[i] = vy;
+        bodies->pos_prev_x[i] = bodies->pos_x[i];
+        bodies->pos_prev_y[i] = bodies->pos_y[i];
+        bodies->pos_x[i] += dx;
+        bodies->pos_y[i] += dy;
+        bodies->bbox_x[i] += dx;
+        bodies->bbox_y[i] += dy;
+    }
+}
+
+#ifdef PHYSICS_HAS_X86_KERNELS
+[[gnu::target("sse2")]]
+static void integrate_sse2 (const struct physics_bodies * bodies, int ibegin, float dt, float dvy, float vmax) {
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdvy = _mm_set1_ps(dvy);
+    const __m128 vhi = _mm_set1_ps(vmax);
+    const __m128 vlo = _mm_set1_ps(-1 * vmax);
+    int i = ibegin;
+    for (; i + 4 <= bodies->n; i += 4) {
+        const __m128 vy = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_loadu_ps(&bodies->vy[i]), vdvy), vlo), vhi);
+        const __m128 dx = _mm_mul_ps(_mm_loadu_ps(&bodies->vx[i]), vdt);
+        const __m128 dy = _mm_mul_ps(vy, vdt);
+        const __m128 pos_x = _mm_loadu_ps(&bodies->pos_x[i]);
+        const __m128 pos_y = _mm_loadu_ps(&bodies->pos_y[i]);
+        _mm_storeu_ps(&bodies->vy[i], vy);
+        _mm_storeu_ps(&bodies->pos_prev_x[i], pos_x);
+        _mm_storeu_ps(&bodies->pos_prev_y[i], pos_y);
+        _mm_storeu_ps(&bodies->pos_x[i], _mm_add_ps(pos_x, dx));
+        _mm_storeu_ps(&bodies->pos_y[i], _mm_add_ps(pos_y, dy));
+        _mm_storeu_ps(&bodies->bbox_x[i], _mm_add_ps(_mm_loadu_ps(&bodies->bbox_x[i]), dx));
+        _mm_storeu_ps(&bodies->bbox_y[i], _mm_add_ps(_mm_loadu_ps(&bodies->bbox_y[i]), dy));
+    }
+    // the remaining bodies don't fill a vector
+    integrate_scalar(bodies, i, dt, dvy, vmax);
+}
+#endif
+
+enum physics_kernel physics_get_best_kernel (void) {
+    // ask the CPU once, the answer doesn't change while running
+    static int best = -1;
+    if (best < 0) {
+        best = PHYSICS_KERNEL_SCALAR;
+#ifdef PHYSICS_HAS_X86_KERNELS
+        if (SDL_HasSSE2()) best = PHYSICS_KERNEL_SSE2;
+        if (SDL_HasAVX2()) best = PHYSICS_KERNEL_AVX2;
+#endif
+    }
+    return (enum physics_kernel) best;
+}
+
+const char * physics_get_kernel_name (enum physics_kernel kernel) {
+    switch (kernel) {
+    case PHYSICS_KERNEL_SCALAR:
+        return "scalar";
+    case PHYSICS_KERNEL_SSE2:
+        return "sse2";
+    case PHYSICS_KERNEL_AVX2:
+        return "avx2";
+    default:
+        return "unknown";
+    }
+}
+
+void physics_integrate (const struct physics_bodies * bodies, float dt, float g, float vmax) {
+    physics_integrate_with(physics_get_best_kernel(), bodies, dt, g, vmax);
+}
+
+void physics_integrate_with (enum physics_kernel kernel, const struct physics_bodies * bodies, float dt, float g, float vmax) {
+    // gravity changes the vertical speed by the same amount for every body, so compute it once,
+    // in single precision
+    const float dvy = 0.5f * g * dt;
+    kernels[kernel](bodies, 0, dt, dvy, vmax);
+}
@@ -0,0 +1,32 @@
+#ifndef MBM_PHYSICS_H_INCLUDED
+#define MBM_PHYSICS_H_INCLUDED
+#include "mbm/abi.h"
+#include <stdint.h>               // uint8_t
+
+// packed arrays of `n` bodies, one array per property; the arrays must not overlap
+struct physics_bodies {
+    float * bbox_x;
+    float * bbox_y;
+    int n;
+    float * pos_prev_x;                       // receives `pos_x` as it was before the step
+    float * pos_prev_y;                       // receives `pos_y` as it was before the step
+    float * pos_x;
+    float * pos_y;
+    const float * vx;
+    float * vy;
+};
+
+// the implementations of the integration step, from slowest to fastest
+enum physics_kernel: uint8_t {
+    PHYSICS_KERNEL_SCALAR = 0,
+    PHYSICS_KERNEL_SSE2,
+    PHYSICS_KERNEL_AVX2,
+    PHYSICS_KERNEL_COUNT,
+};
+
+MBM_NO_ABI enum physics_kernel physics_get_best_kernel (void);
+MBM_NO_ABI const char * physics_get_kernel_name (enum physics_kernel kernel);
+MBM_NO_ABI void physics_integrate (const struct physics_bodies * bodies, float dt, float g, float vmax);
+MBM_NO_ABI void physics_integrate_with (enum physics_kernel kernel, const struct physics_bodies * bodies, float dt, float g, float vmax);
+
+#endif
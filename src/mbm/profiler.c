@@ -0,0 +1,137 @@
+#include "profiler.h"
+#include "SDL3/SDL_atomic.h"      // SDL_AtomicInt, SDL_AddAtomicInt, SDL_GetAtomicInt
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_iostream.h"    // SDL_IOStream, SDL_IOFromFile, SDL_IOprintf, SDL_CloseIO
+#include "SDL3/SDL_log.h"         // SDL_LogCritical, SDL_LogWarn, SDL_Log
+#include "SDL3/SDL_stdinc.h"      // SDL_calloc
+#include "SDL3/SDL_timer.h"       // SDL_GetTicksNS
+#include <stdint.h>               // uint64_t
+#include <stdlib.h>               // exit
+
+// capacity of each thread's ring buffer of scopes
+#define PROFILER_NEVENTS_CAP 65536
+
+// capacity of the ring buffer of frame starts
+#define PROFILER_NFRAMES_CAP 1024
+
+// maximum number of threads that can record scopes
+#define PROFILER_NTHREADS_CAP 16
+
+struct event {
+    const char * name;
+    uint64_t tbegin;                          // nanoseconds
+    uint64_t tend;                            // nanoseconds
+};
+
+struct ring {
+    struct event * events;
+    uint64_t nevents;                         // number of events recorded since the start
+};
+
+// each thread records into its own ring, which it claims from `rings` when it registers with
+// profiler_register_thread(); the ring's memory is allocated at that point, such that recording a
+// scope never allocates
+static struct ring rings[PROFILER_NTHREADS_CAP];
+static SDL_AtomicInt nrings;
+static thread_local struct ring * ring = nullptr;
+
+// frame starts, as marked by profiler_mark_frame()
+static uint64_t frames[PROFILER_NFRAMES_CAP];
+static uint64_t nframes_marked = 0;
+
+// forward declarations of functions defined below
+static struct ring * claim_ring (void);
+
+static struct ring * claim_ring (void) {
+    const int iring = SDL_AddAtomicInt(&nrings, 1);
+    if (iring >= PROFILER_NTHREADS_CAP) {
+        // too many threads; this thread's scopes won't be recorded
+        return nullptr;
+    }
+    struct event * events = SDL_calloc(PROFILER_NEVENTS_CAP, sizeof(struct event));
+    if (events == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Couldn't create dynamic memory for storing profiler events, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    rings[iring] = (struct ring) {
+        .events = events,
+        .nevents = 0,
+    };
+    return &rings[iring];
+}
+
+struct profiler_scope profiler_begin (const char * name) {
+    return (struct profiler_scope) {
+        .name = name,
+        .tbegin = SDL_GetTicksNS(),
+    };
+}
+
+void profiler_dump (const char * path, int nframes) {
+
+    // only keep scopes that started in the last `nframes` frames
+    const uint64_t nframes_avail = SDL_min(nframes_marked, (uint64_t) PROFILER_NFRAMES_CAP);
+    const uint64_t nframes_dump = SDL_min((uint64_t) nframes, nframes_avail);
+    const uint64_t tcutoff = nframes_dump == 0 ? 0 : frames[(nframes_marked - nframes_dump) % PROFILER_NFRAMES_CAP];
+
+    SDL_IOStream * stream = SDL_IOFromFile(path, "w");
+    if (stream == nullptr) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "Couldn't open '%s' for writing the profiler trace; %s\n",
+                    path, SDL_GetError());
+        return;
+    }
+
+    // write the scopes as complete events in Chrome's trace event format, with one `tid` per ring
+    uint64_t nevents_dumped = 0;
+    SDL_IOprintf(stream, "{\"traceEvents\":[");
+    const int nrings_claimed = SDL_min(SDL_GetAtomicInt(&nrings), PROFILER_NTHREADS_CAP);
+    for (int iring = 0; iring < nrings_claimed; iring++) {
+        const struct ring * r = &rings[iring];
+        const uint64_t nevents_avail = SDL_min(r->nevents, (uint64_t) PROFILER_NEVENTS_CAP);
+        for (uint64_t i = r->nevents - nevents_avail; i < r->nevents; i++) {
+            const struct event * e = &r->events[i % PROFILER_NEVENTS_CAP];
+            if (e->tbegin < tcutoff) continue;
+            SDL_IOprintf(stream,
+                         "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         nevents_dumped == 0 ? "" : ",",
+                         e->name, iring, e->tbegin / 1e3, (e->tend - e->tbegin) / 1e3);
+            nevents_dumped++;
+        }
+    }
+    SDL_IOprintf(stream, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    SDL_CloseIO(stream);
+
+    if (nevents_dumped == 0) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "Profiler trace '%s' is empty; was the library configured with MBM_PROFILE=ON?\n",
+                    path);
+        return;
+    }
+    SDL_Log("Wrote %d frames of profiler trace to '%s'\n", (int) nframes_dump, path);
+}
+
+void profiler_end (struct profiler_scope * scope) {
+    if (ring == nullptr) {
+        // the thread didn't register, or there were too many threads; don't record the scope
+        return;
+    }
+    ring->events[ring->nevents % PROFILER_NEVENTS_CAP] = (struct event) {
+        .name = scope->name,
+        .tbegin = scope->tbegin,
+        .tend = SDL_GetTicksNS(),
+    };
+    ring->nevents++;
+}
+
+void profiler_mark_frame (void) {
+    frames[nframes_marked % PROFILER_NFRAMES_CAP] = SDL_GetTicksNS();
+    nframes_marked++;
+}
+
+void profiler_register_thread (void) {
+    if (ring != nullptr) return;
+    ring = claim_ring();
+}
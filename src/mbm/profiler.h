@@ -0,0 +1,36 @@
+#ifndef MBM_PROFILER_H_INCLUDED
+#define MBM_PROFILER_H_INCLUDED
+#include "mbm/abi.h"
+#include <stdint.h>               // uint64_t
+
+// `struct profiler_scope` holds the start of a scope that is being timed; it lives on the stack
+// of the function that is being profiled
+struct profiler_scope {
+    const char * name;
+    uint64_t tbegin;                          // nanoseconds
+};
+
+MBM_NO_ABI struct profiler_scope profiler_begin (const char * name);
+MBM_NO_ABI void profiler_dump (const char * path, int nframes);
+MBM_NO_ABI void profiler_end (struct profiler_scope * scope);
+MBM_NO_ABI void profiler_mark_frame (void);
+MBM_NO_ABI void profiler_register_thread (void);
+
+// When MBM_PROFILE is defined, `MBM_PROFILE_SCOPE(name)` times the remainder of the enclosing
+// block, `MBM_PROFILE_FRAME()` marks the start of a frame, and `MBM_PROFILE_THREAD()` sets up the
+// calling thread for recording scopes; scopes of threads that didn't are dropped. Otherwise, all
+// three expand to nothing.
+#ifdef MBM_PROFILE
+#define MBM_PROFILE_CONCAT_(a, b) a##b
+#define MBM_PROFILE_CONCAT(a, b) MBM_PROFILE_CONCAT_(a, b)
+#define MBM_PROFILE_SCOPE(name) \
+    [[gnu::cleanup(profiler_end)]] struct profiler_scope MBM_PROFILE_CONCAT(profiler_scope_, __LINE__) = profiler_begin(name)
+#define MBM_PROFILE_FRAME() profiler_mark_frame()
+#define MBM_PROFILE_THREAD() profiler_register_thread()
+#else
+#define MBM_PROFILE_SCOPE(name)
+#define MBM_PROFILE_FRAME()
+#define MBM_PROFILE_THREAD()
+#endif // MBM_PROFILE
+
+#endif
@@ -0,0 +1,220 @@
+#include "resources.h"
+#include "loader.h"               // struct loader, loader_create_texture, loader_open_font
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_filesystem.h"  // SDL_GetBasePath, SDL_GetPathInfo, SDL_PathInfo
+#include "SDL3/SDL_log.h"         // SDL_Log, SDL_LogCritical, SDL_LogWarn
+#include "SDL3/SDL_pixels.h"      // SDL_BYTESPERPIXEL
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_DestroyTexture
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_free, SDL_realloc, SDL_strcmp
+#include <SDL3_ttf/SDL_ttf.h>     // TTF_Font, TTF_CloseFont, TTF_SetFontSize
+#include <stddef.h>               // size_t
+#include <stdlib.h>               // exit
+
+enum resource_kind: uint8_t {
+    RESOURCE_KIND_FONT = 0,
+    RESOURCE_KIND_TEXTURE,
+};
+
+struct resource {
+    TTF_Font * font;
+    enum resource_kind kind;
+    size_t nbytes;                            // file size for fonts, pixel data size for textures
+    int nrefs;
+    char * relpath;
+    SDL_Texture * texture;
+};
+
+// declare properties of `struct resources`
+struct resources {
+    struct resource * entries;
+    struct loader * loader;                   // decodes what isn't cached yet
+    int n;
+    int ncap;
+};
+
+// forward declaration of static functions
+static struct resource * add (struct resources * self, enum resource_kind kind, const char * relpath);
+static void destroy (struct resource * resource);
+static struct resource * find_by_handle (struct resources * self, const void * handle);
+static struct resource * find_by_path (struct resources * self, enum resource_kind kind, const char * relpath);
+static const char * get_kind_name (enum resource_kind kind);
+static void release (struct resources * self, struct resource * resource);
+
+// define pointer to singleton instance of `struct resources`
+static struct resources * singleton = nullptr;
+
+static struct resource * add (struct resources * self, enum resource_kind kind, const char * relpath) {
+    if (self->n == self->ncap) {
+        const int ncap = self->ncap > 0 ? 2 * self->ncap : 8;
+        struct resource * entries = (struct resource *) SDL_realloc(self->entries, ncap * sizeof(struct resource));
+        if (entries == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "ERROR allocating dynamic memory for resource entries, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+        self->entries = entries;
+        self->ncap = ncap;
+    }
+    struct resource * resource = &self->entries[self->n];
+    *resource = (struct resource) {
+        .kind = kind,
+        .nrefs = 1,
+    };
+    SDL_asprintf(&resource->relpath, "%s", relpath);
+    self->n++;
+    return resource;
+}
+
+static void destroy (struct resource * resource) {
+    if (resource->font != nullptr) {
+        TTF_CloseFont(resource->font);
+        resource->font = nullptr;
+    }
+    SDL_DestroyTexture(resource->texture);
+    resource->texture = nullptr;
+    SDL_free(resource->relpath);
+    resource->relpath = nullptr;
+}
+
+static struct resource * find_by_handle (struct resources * self, const void * handle) {
+    for (int i = 0; i < self->n; i++) {
+        struct resource * resource = &self->entries[i];
+        if ((const void *) resource->font == handle || (const void *) resource->texture == handle) {
+            return resource;
+        }
+    }
+    SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                    "Released a resource that wasn't acquired, aborting.\n");
+    exit(1);
+}
+
+static struct resource * find_by_path (struct resources * self, enum resource_kind kind, const char * relpath) {
+    for (int i = 0; i < self->n; i++) {
+        struct resource * resource = &self->entries[i];
+        if (resource->kind == kind && SDL_strcmp(resource->relpath, relpath) == 0) {
+            return resource;
+        }
+    }
+    return nullptr;
+}
+
+static const char * get_kind_name (enum resource_kind kind) {
+    switch (kind) {
+    case RESOURCE_KIND_FONT:
+        return "font";
+    case RESOURCE_KIND_TEXTURE:
+        return "texture";
+    default:
+        return "unknown";
+    }
+}
+
+static void release (struct resources * self, struct resource * resource) {
+    resource->nrefs--;
+    if (resource->nrefs > 0) return;
+
+    // last user is gone; move the last entry into the freed spot
+    destroy(resource);
+    *resource = self->entries[self->n - 1];
+    self->n--;
+}
+
+TTF_Font * resources_acquire_font (struct resources * self, const char * relpath, float ptsize) {
+    // a font file is opened once and shared between all sizes; the size is set on every acquire,
+    // so rasterize what's needed before acquiring the same font at another size
+    struct resource * resource = find_by_path(self, RESOURCE_KIND_FONT, relpath);
+    if (resource != nullptr) {
+        resource->nrefs++;
+        TTF_SetFontSize(resource->font, ptsize);
+        return resource->font;
+    }
+    TTF_Font * font = loader_open_font(self->loader, relpath, ptsize);
+    char * path = nullptr;
+    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
+    SDL_PathInfo info = {};
+    SDL_GetPathInfo(path, &info);
+    SDL_free(path);
+    path = nullptr;
+    resource = add(self, RESOURCE_KIND_FONT, relpath);
+    resource->font = font;
+    resource->nbytes = (size_t) info.size;
+    return font;
+}
+
+SDL_Texture * resources_acquire_texture (struct resources * self, const char * relpath, SDL_Renderer * renderer) {
+    struct resource * resource = find_by_path(self, RESOURCE_KIND_TEXTURE, relpath);
+    if (resource != nullptr) {
+        resource->nrefs++;
+        return resource->texture;
+    }
+    SDL_Texture * texture = loader_create_texture(self->loader, relpath, renderer);
+    resource = add(self, RESOURCE_KIND_TEXTURE, relpath);
+    resource->texture = texture;
+    resource->nbytes = (size_t) texture->w * texture->h * SDL_BYTESPERPIXEL(texture->format);
+    return texture;
+}
+
+void resources_delete (struct resources ** self) {
+    for (int i = 0; i < (*self)->n; i++) {
+        struct resource * resource = &(*self)->entries[i];
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "%s '%s' still has %d reference(s) at exit\n",
+                    get_kind_name(resource->kind), resource->relpath, resource->nrefs);
+        destroy(resource);
+    }
+    SDL_free((*self)->entries);
+    (*self)->entries = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+    singleton = nullptr;
+}
+
+size_t resources_get_nbytes (const struct resources * self) {
+    size_t nbytes = 0;
+    for (int i = 0; i < self->n; i++) {
+        nbytes += self->entries[i].nbytes;
+    }
+    return nbytes;
+}
+
+void resources_init (struct resources * self, struct loader * loader) {
+    *self = (struct resources) {
+        .entries = nullptr,
+        .loader = loader,
+        .n = 0,
+        .ncap = 0,
+    };
+}
+
+void resources_log (const struct resources * self) {
+    for (int i = 0; i < self->n; i++) {
+        const struct resource * resource = &self->entries[i];
+        SDL_Log("resources: %-7s %10zu bytes, %2d reference(s), %s\n", get_kind_name(resource->kind),
+                resource->nbytes, resource->nrefs, resource->relpath);
+    }
+    SDL_Log("resources: total   %10zu bytes\n", resources_get_nbytes(self));
+}
+
+struct resources * resources_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct resources *) SDL_calloc(1, sizeof(struct resources));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct resources, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
+
+void resources_release_font (struct resources * self, TTF_Font * font) {
+    release(self, find_by_handle(self, font));
+}
+
+void resources_release_texture (struct resources * self, SDL_Texture * texture) {
+    release(self, find_by_handle(self, texture));
+}
@@ -0,0 +1,23 @@
+#ifndef MBM_RESOURCES_H_INCLUDED
+#define MBM_RESOURCES_H_INCLUDED
+#include "mbm/abi.h"
+#include "loader.h"               // struct loader
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture
+#include <SDL3_ttf/SDL_ttf.h>     // TTF_Font
+#include <stddef.h>               // size_t
+
+// `struct resources` is an opaque data structure;
+// only the implementation has access to its layout
+struct resources;
+
+MBM_NO_ABI TTF_Font * resources_acquire_font (struct resources * self, const char * relpath, float ptsize);
+MBM_NO_ABI SDL_Texture * resources_acquire_texture (struct resources * self, const char * relpath, SDL_Renderer * renderer);
+MBM_NO_ABI void resources_delete (struct resources ** self);
+MBM_NO_ABI size_t resources_get_nbytes (const struct resources * self);
+MBM_NO_ABI void resources_init (struct resources * self, struct loader * loader);
+MBM_NO_ABI void resources_log (const struct resources * self);
+MBM_NO_ABI struct resources * resources_new (void);
+MBM_NO_ABI void resources_release_font (struct resources * self, TTF_Font * font);
+MBM_NO_ABI void resources_release_texture (struct resources * self, SDL_Texture * texture);
+
+#endif
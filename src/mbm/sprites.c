@@ -0,0 +1,240 @@
+#include "sprites.h"
+#include "profiler.h"             // MBM_PROFILE_SCOPE
+#include "SDL3/SDL_blendmode.h"   // SDL_BLENDMODE_BLEND
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_pixels.h"      // SDL_FColor
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_Vertex, SDL_GetTextureSize, SDL_RenderGeometry
+#include "SDL3/SDL_stdinc.h"      // SDL_calloc, SDL_free, SDL_memcpy, SDL_qsort, SDL_realloc
+#include <stdint.h>               // uintptr_t
+#include <stdlib.h>               // exit
+
+// a run of consecutively pushed quads that share a layer and a texture
+struct run {
+    int iquad;                                // first quad in `vertices`
+    enum sprites_layer layer;
+    int nquads;
+    int seq;                                  // order of pushing, which keeps the sort stable
+    SDL_Texture * texture;
+};
+
+// declare properties of `struct sprites`; quads are collected in order of pushing, and copied
+// into `sorted` in order of drawing when flushed
+struct sprites {
+    int * indices;                            // the same 6 indices per quad, for `nquads_cap` quads
+    int ncalls;                               // draw calls made by the last flush
+    int nquads;
+    int nquads_cap;
+    int nruns;
+    int nruns_cap;
+    struct run * runs;
+    SDL_Vertex * sorted;
+    SDL_Vertex * vertices;
+};
+
+// define pointer to singleton instance of `struct sprites`
+static struct sprites * singleton = nullptr;
+
+// forward declaration of static functions
+static void append (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, int nquads);
+static int compare_runs (const void * a, const void * b);
+static void * reallocate (void * ptr, size_t n, size_t size);
+static void reserve (struct sprites * self, int nquads);
+
+static void append (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, int nquads) {
+
+    // quads that are pushed after each other with the same keys extend the last run, such that
+    // e.g. a crowd of ducks takes one run rather than one per duck
+    if (self->nruns > 0) {
+        struct run * last = &self->runs[self->nruns - 1];
+        if (last->layer == layer && last->texture == texture) {
+            last->nquads += nquads;
+            self->nquads += nquads;
+            return;
+        }
+    }
+    if (self->nruns == self->nruns_cap) {
+        self->nruns_cap = self->nruns_cap > 0 ? 2 * self->nruns_cap : 16;
+        self->runs = reallocate(self->runs, self->nruns_cap, sizeof(struct run));
+    }
+    self->runs[self->nruns] = (struct run) {
+        .iquad = self->nquads,
+        .layer = layer,
+        .nquads = nquads,
+        .seq = self->nruns,
+        .texture = texture,
+    };
+    self->nruns++;
+    self->nquads += nquads;
+}
+
+static int compare_runs (const void * a, const void * b) {
+    const struct run * ra = (const struct run *) a;
+    const struct run * rb = (const struct run *) b;
+    if (ra->layer != rb->layer) return ra->layer < rb->layer ? -1 : 1;
+    if (ra->texture != rb->texture) return (uintptr_t) ra->texture < (uintptr_t) rb->texture ? -1 : 1;
+    return ra->seq < rb->seq ? -1 : ra->seq > rb->seq;
+}
+
+static void * reallocate (void * ptr, size_t n, size_t size) {
+    void * tmp = SDL_realloc(ptr, n * size);
+    if (tmp == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for the sprite batch, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return tmp;
+}
+
+static void reserve (struct sprites * self, int nquads) {
+    if (self->nquads + nquads <= self->nquads_cap) return;
+    int nquads_cap = self->nquads_cap > 0 ? self->nquads_cap : 256;
+    while (nquads_cap < self->nquads + nquads) {
+        nquads_cap *= 2;
+    }
+    self->indices = reallocate(self->indices, 6 * nquads_cap, sizeof(int));
+    self->sorted = reallocate(self->sorted, 4 * nquads_cap, sizeof(SDL_Vertex));
+    self->vertices = reallocate(self->vertices, 4 * nquads_cap, sizeof(SDL_Vertex));
+
+    // every run is drawn from the start of `indices`, so the pattern only needs extending
+    for (int i = self->nquads_cap; i < nquads_cap; i++) {
+        self->indices[6 * i + 0] = 4 * i + 0;
+        self->indices[6 * i + 1] = 4 * i + 1;
+        self->indices[6 * i + 2] = 4 * i + 2;
+        self->indices[6 * i + 3] = 4 * i + 2;
+        self->indices[6 * i + 4] = 4 * i + 3;
+        self->indices[6 * i + 5] = 4 * i + 0;
+    }
+    self->nquads_cap = nquads_cap;
+}
+
+void sprites_delete (struct sprites ** self) {
+    SDL_free((*self)->indices);
+    SDL_free((*self)->runs);
+    SDL_free((*self)->sorted);
+    SDL_free((*self)->vertices);
+    SDL_free(*self);
+    *self = nullptr;
+    singleton = nullptr;
+}
+
+void sprites_flush (struct sprites * self, SDL_Renderer * renderer) {
+    MBM_PROFILE_SCOPE("sprites_flush");
+
+    // order the runs by layer, then by texture, then by order of pushing
+    SDL_qsort(self->runs, (size_t) self->nruns, sizeof(struct run), compare_runs);
+
+    // gather the quads in drawing order, and submit each stretch that shares a texture at once;
+    // neighboring runs may belong to different layers, their order is kept all the same
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    int ncalls = 0;
+    int nsorted = 0;
+    int isorted_s = 0;
+    for (int i = 0; i < self->nruns; i++) {
+        const struct run * run = &self->runs[i];
+        SDL_memcpy(&self->sorted[4 * nsorted], &self->vertices[4 * run->iquad], 4 * run->nquads * sizeof(SDL_Vertex));
+        nsorted += run->nquads;
+        if (i + 1 < self->nruns && self->runs[i + 1].texture == run->texture) continue;
+        const int n = nsorted - isorted_s;
+        SDL_RenderGeometry(renderer, run->texture, &self->sorted[4 * isorted_s], 4 * n, self->indices, 6 * n);
+        isorted_s = nsorted;
+        ncalls++;
+    }
+
+    // start collecting the next frame
+    self->ncalls = ncalls;
+    self->nquads = 0;
+    self->nruns = 0;
+}
+
+int sprites_get_ncalls (const struct sprites * self) {
+    return self->ncalls;
+}
+
+void sprites_init (struct sprites * self) {
+    *self = (struct sprites) {
+        .indices = nullptr,
+        .ncalls = 0,
+        .nquads = 0,
+        .nquads_cap = 0,
+        .nruns = 0,
+        .nruns_cap = 0,
+        .runs = nullptr,
+        .sorted = nullptr,
+        .vertices = nullptr,
+    };
+    reserve(self, 1);
+}
+
+struct sprites * sprites_new (void) {
+    if (singleton != nullptr) {
+        // memory has already been allocated for `singleton`
+        return singleton;
+    }
+    singleton = (struct sprites *) SDL_calloc(1, sizeof(struct sprites));
+    if (singleton == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for struct sprites, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return singleton;
+}
+
+void sprites_push (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, SDL_FRect src, SDL_FRect dst, SDL_FColor color) {
+
+    // `src` is in pixels; untextured quads ignore it
+    float u0 = 0.0f;
+    float u1 = 0.0f;
+    float v0 = 0.0f;
+    float v1 = 0.0f;
+    if (texture != nullptr) {
+        float texture_h = 0.0f;
+        float texture_w = 0.0f;
+        SDL_GetTextureSize(texture, &texture_w, &texture_h);
+        u0 = src.x / texture_w;
+        u1 = (src.x + src.w) / texture_w;
+        v0 = src.y / texture_h;
+        v1 = (src.y + src.h) / texture_h;
+    }
+    reserve(self, 1);
+    SDL_Vertex * v = &self->vertices[4 * self->nquads];
+    v[0] = (SDL_Vertex) { .position = { dst.x, dst.y }, .color = color, .tex_coord = { u0, v0 } };
+    v[1] = (SDL_Vertex) { .position = { dst.x + dst.w, dst.y }, .color = color, .tex_coord = { u1, v0 } };
+    v[2] = (SDL_Vertex) { .position = { dst.x + dst.w, dst.y + dst.h }, .color = color, .tex_coord = { u1, v1 } };
+    v[3] = (SDL_Vertex) { .position = { dst.x, dst.y + dst.h }, .color = color, .tex_coord = { u0, v1 } };
+    append(self, layer, texture, 1);
+}
+
+void sprites_push_outline (struct sprites * self, enum sprites_layer layer, SDL_FRect rect, SDL_FColor color) {
+    // a 1 pixel wide outline on the inside of `rect`, as 4 untextured quads
+    const SDL_FRect src = {};
+    sprites_push(self, layer, nullptr, src, (SDL_FRect) { rect.x, rect.y, rect.w, 1.0f }, color);
+    sprites_push(self, layer, nullptr, src, (SDL_FRect) { rect.x, rect.y + rect.h - 1.0f, rect.w, 1.0f }, color);
+    sprites_push(self, layer, nullptr, src, (SDL_FRect) { rect.x, rect.y + 1.0f, 1.0f, rect.h - 2.0f }, color);
+    sprites_push(self, layer, nullptr, src, (SDL_FRect) { rect.x + rect.w - 1.0f, rect.y + 1.0f, 1.0f, rect.h - 2.0f }, color);
+}
+
+void sprites_push_quads (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, const SDL_Vertex * vertices, int nquads) {
+    // `vertices` holds 4 vertices per quad, clockwise from the top left corner
+    if (nquads <= 0) return;
+    reserve(self, nquads);
+    SDL_memcpy(&self->vertices[4 * self->nquads], vertices, 4 * nquads * sizeof(SDL_Vertex));
+    append(self, layer, texture, nquads);
+}
+
+void sprites_push_quads_translated (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, const SDL_Vertex * vertices, int nquads, SDL_FPoint offset) {
+    // like sprites_push_quads(), but moved by `offset` while copying, such that e.g. quads that
+    // are kept in world coordinates don't need updating when the camera moves
+    if (nquads <= 0) return;
+    reserve(self, nquads);
+    SDL_Vertex * v = &self->vertices[4 * self->nquads];
+    for (int i = 0; i < 4 * nquads; i++) {
+        v[i] = vertices[i];
+        v[i].position.x += offset.x;
+        v[i].position.y += offset.y;
+    }
+    append(self, layer, texture, nquads);
+}
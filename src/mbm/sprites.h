@@ -0,0 +1,34 @@
+#ifndef MBM_SPRITES_H_INCLUDED
+#define MBM_SPRITES_H_INCLUDED
+#include "mbm/abi.h"
+#include "SDL3/SDL_pixels.h"      // SDL_FColor
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_Vertex
+#include <stdint.h>               // uint8_t
+
+// layers are drawn back to front; within a layer, quads are grouped by texture, so quads that
+// overlap should either share a texture or live in different layers
+enum sprites_layer: uint8_t {
+    SPRITES_LAYER_WORLD = 0,
+    SPRITES_LAYER_DUCKS,
+    SPRITES_LAYER_BBOXES,
+    SPRITES_LAYER_OVERLAY,
+    SPRITES_LAYER_TEXT,
+    SPRITES_LAYER_COUNT,
+};
+
+// `struct sprites` is an opaque data structure;
+// only the implementation has access to its layout
+struct sprites;
+
+MBM_NO_ABI void sprites_delete (struct sprites ** self);
+MBM_NO_ABI void sprites_flush (struct sprites * self, SDL_Renderer * renderer);
+MBM_NO_ABI int sprites_get_ncalls (const struct sprites * self);
+MBM_NO_ABI void sprites_init (struct sprites * self);
+MBM_NO_ABI struct sprites * sprites_new (void);
+MBM_NO_ABI void sprites_push (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, SDL_FRect src, SDL_FRect dst, SDL_FColor color);
+MBM_NO_ABI void sprites_push_outline (struct sprites * self, enum sprites_layer layer, SDL_FRect rect, SDL_FColor color);
+MBM_NO_ABI void sprites_push_quads (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, const SDL_Vertex * vertices, int nquads);
+MBM_NO_ABI void sprites_push_quads_translated (struct sprites * self, enum sprites_layer layer, SDL_Texture * texture, const SDL_Vertex * vertices, int nquads, SDL_FPoint offset);
+
+#endif
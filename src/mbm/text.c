@@ -0,0 +1,217 @@
+#include "text.h"
+#include "resources.h"            // struct resources, resources_acquire_font, resources_release_font
+#include "sprites.h"              // struct sprites, sprites_push_quads, SPRITES_LAYER_TEXT
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_log.h"         // SDL_LogCritical
+#include "SDL3/SDL_pixels.h"      // SDL_Color, SDL_FColor, SDL_PIXELFORMAT_RGBA32
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect, SDL_Rect
+#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_Vertex, SDL_CreateTextureFromSurface
+#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc
+#include "SDL3/SDL_surface.h"     // SDL_Surface, SDL_CreateSurface, SDL_BlitSurface, SDL_DestroySurface
+#include <SDL3_ttf/SDL_ttf.h>     // TTF_Font, TTF_GetGlyphMetrics, TTF_RenderGlyph_Solid
+#include <stdlib.h>               // exit
+
+// the atlas holds the printable ASCII characters; anything else is drawn as '?'
+#define TEXT_GLYPH_FIRST ' '
+#define TEXT_GLYPH_LAST '~'
+#define TEXT_NGLYPHS (TEXT_GLYPH_LAST - TEXT_GLYPH_FIRST + 1)
+
+// upper limit on the number of characters per call to text_draw(); longer strings are cut off, so
+// this has to be at least as long as the longest caption, i.e. the frame graph's stats line
+#define TEXT_NCHARS_MAX 128
+
+// glyphs are packed in rows no wider than this many pixels, separated by a 1 pixel gutter
+#define TEXT_ATLAS_WIDTH_MAX 1024
+
+struct glyph {
+    float advance;                            // pixels
+    SDL_FRect src;                            // pixels, in the atlas
+    SDL_FRect uv;                             // normalized, in the atlas
+};
+
+// declare properties of `struct text`
+struct text {
+    TTF_Font * font;                          // shared, held until text_delete() so it's opened once
+    struct glyph glyphs[TEXT_NGLYPHS];
+    float h;                                  // pixels
+    struct resources * resources;
+    SDL_Texture * texture;
+};
+
+// forward declarations of functions defined below
+static const struct glyph * get_glyph (const struct text * self, char c);
+
+static const struct glyph * get_glyph (const struct text * self, char c) {
+    if (c < TEXT_GLYPH_FIRST || c > TEXT_GLYPH_LAST) {
+        c = '?';
+    }
+    return &self->glyphs[c - TEXT_GLYPH_FIRST];
+}
+
+void text_delete (struct text ** self) {
+    resources_release_font((*self)->resources, (*self)->font);
+    (*self)->font = nullptr;
+    SDL_DestroyTexture((*self)->texture);
+    (*self)->texture = nullptr;
+    SDL_free(*self);
+    *self = nullptr;
+}
+
+void text_draw (const struct text * self, struct sprites * sprites, const char * str, SDL_FPoint wld, float scale, SDL_Color color) {
+
+    // the vertices live on the stack, so drawing text doesn't allocate
+    SDL_Vertex vertices[4 * TEXT_NCHARS_MAX];
+    const SDL_FColor fcolor = (SDL_FColor) {
+        .r = color.r / 255.0f,
+        .g = color.g / 255.0f,
+        .b = color.b / 255.0f,
+        .a = color.a / 255.0f,
+    };
+
+    // lay out one quad per visible character
+    int nquads = 0;
+    float x = wld.x;
+    for (int i = 0; str[i] != '\0' && i < TEXT_NCHARS_MAX; i++) {
+        const struct glyph * glyph = get_glyph(self, str[i]);
+        if (glyph->src.w > 0.0f) {
+            const float x0 = x;
+            const float x1 = x + glyph->src.w * scale;
+            const float y0 = wld.y;
+            const float y1 = wld.y + glyph->src.h * scale;
+            const float u0 = glyph->uv.x;
+            const float u1 = glyph->uv.x + glyph->uv.w;
+            const float v0 = glyph->uv.y;
+            const float v1 = glyph->uv.y + glyph->uv.h;
+            SDL_Vertex * v = &vertices[4 * nquads];
+            v[0] = (SDL_Vertex) { .position = { x0, y0 }, .color = fcolor, .tex_coord = { u0, v0 } };
+            v[1] = (SDL_Vertex) { .position = { x1, y0 }, .color = fcolor, .tex_coord = { u1, v0 } };
+            v[2] = (SDL_Vertex) { .position = { x1, y1 }, .color = fcolor, .tex_coord = { u1, v1 } };
+            v[3] = (SDL_Vertex) { .position = { x0, y1 }, .color = fcolor, .tex_coord = { u0, v1 } };
+            nquads++;
+        }
+        x += glyph->advance * scale;
+    }
+
+    // hand over the whole string as one run
+    sprites_push_quads(sprites, SPRITES_LAYER_TEXT, self->texture, vertices, nquads);
+}
+
+void text_get_size (const struct text * self, const char * str, float scale, float * w, float * h) {
+    float x = 0.0f;
+    for (int i = 0; str[i] != '\0' && i < TEXT_NCHARS_MAX; i++) {
+        x += get_glyph(self, str[i])->advance;
+    }
+    *w = x * scale;
+    *h = self->h * scale;
+}
+
+struct text * text_new (const char * relpath, float ptsize, SDL_Renderer * renderer, struct resources * resources) {
+
+    struct text * text = nullptr;
+    TTF_Font * font = nullptr;
+    SDL_Surface * surfaces[TEXT_NGLYPHS] = {};
+    SDL_Surface * atlas = nullptr;
+    int atlas_h = 0;
+    int atlas_w = 0;
+
+    // allocate dynamic memory for holding the struct text (`self`)
+    {
+        text = SDL_calloc(1, sizeof(struct text));
+        if (text == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Couldn't create dynamic memory for storing struct text, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+    }
+
+    // rasterize every glyph once, and shelf-pack their rectangles into rows
+    {
+        font = resources_acquire_font(resources, relpath, ptsize);
+        text->font = font;
+        text->resources = resources;
+        const SDL_Color white = (SDL_Color) {
+            .r = 255,
+            .g = 255,
+            .b = 255,
+            .a = SDL_ALPHA_OPAQUE,
+        };
+        int x = 1;
+        int y = 1;
+        int hrow = 0;
+        for (int i = 0; i < TEXT_NGLYPHS; i++) {
+            const Uint32 ch = (Uint32) (TEXT_GLYPH_FIRST + i);
+            int advance = 0;
+            TTF_GetGlyphMetrics(font, ch, nullptr, nullptr, nullptr, nullptr, &advance);
+            text->glyphs[i].advance = (float) advance;
+            surfaces[i] = TTF_RenderGlyph_Solid(font, ch, white);
+            if (surfaces[i] == nullptr) {
+                // no pixels for this glyph, e.g. whitespace
+                continue;
+            }
+            if (x + surfaces[i]->w + 1 > TEXT_ATLAS_WIDTH_MAX) {
+                x = 1;
+                y += hrow + 1;
+                hrow = 0;
+            }
+            text->glyphs[i].src = (SDL_FRect) {
+                .h = (float) surfaces[i]->h,
+                .w = (float) surfaces[i]->w,
+                .x = (float) x,
+                .y = (float) y,
+            };
+            x += surfaces[i]->w + 1;
+            hrow = SDL_max(hrow, surfaces[i]->h);
+            atlas_w = SDL_max(atlas_w, x);
+        }
+        atlas_h = y + hrow + 1;
+        text->h = (float) TTF_GetFontHeight(font);
+        font = nullptr;
+    }
+
+    // blit the glyphs into a single transparent surface
+    {
+        atlas = SDL_CreateSurface(atlas_w, atlas_h, SDL_PIXELFORMAT_RGBA32);
+        if (atlas == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Couldn't create surface for glyph atlas, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+        for (int i = 0; i < TEXT_NGLYPHS; i++) {
+            if (surfaces[i] == nullptr) continue;
+            SDL_FRect * src = &text->glyphs[i].src;
+            SDL_Rect dst = (SDL_Rect) {
+                .h = (int) src->h,
+                .w = (int) src->w,
+                .x = (int) src->x,
+                .y = (int) src->y,
+            };
+            SDL_BlitSurface(surfaces[i], nullptr, atlas, &dst);
+            text->glyphs[i].uv = (SDL_FRect) {
+                .h = src->h / (float) atlas_h,
+                .w = src->w / (float) atlas_w,
+                .x = src->x / (float) atlas_w,
+                .y = src->y / (float) atlas_h,
+            };
+            SDL_DestroySurface(surfaces[i]);
+            surfaces[i] = nullptr;
+        }
+    }
+
+    // upload the atlas once
+    {
+        text->texture = SDL_CreateTextureFromSurface(renderer, atlas);
+        if (text->texture == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Couldn't create texture for glyph atlas, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+        SDL_SetTextureScaleMode(text->texture, SDL_SCALEMODE_NEAREST);
+        SDL_DestroySurface(atlas);
+        atlas = nullptr;
+    }
+
+    return text;
+}
@@ -0,0 +1,19 @@
+#ifndef MBM_TEXT_H_INCLUDED
+#define MBM_TEXT_H_INCLUDED
+#include "mbm/abi.h"
+#include "resources.h"            // struct resources and associated functions
+#include "sprites.h"              // struct sprites
+#include "SDL3/SDL_pixels.h"      // SDL_Color
+#include "SDL3/SDL_rect.h"        // SDL_FPoint
+#include "SDL3/SDL_render.h"      // SDL_Renderer
+
+// `struct text` is an opaque data structure;
+// only the implementation has access to its layout
+struct text;
+
+MBM_NO_ABI void text_delete (struct text ** self);
+MBM_NO_ABI void text_draw (const struct text * self, struct sprites * sprites, const char * str, SDL_FPoint wld, float scale, SDL_Color color);
+MBM_NO_ABI void text_get_size (const struct text * self, const char * str, float scale, float * w, float * h);
+MBM_NO_ABI struct text * text_new (const char * relpath, float ptsize, SDL_Renderer * renderer, struct resources * resources);
+
+#endif
@@ -1,23 +1,78 @@
 #include "mbm/timings.h"          // struct timings and associated functions
+#include "SDL3/SDL_atomic.h"      // SDL_CPUPauseInstruction
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_log.h"         // SDL_LogCritical
-#include "SDL3/SDL_stdinc.h"      // SDL_free, SDL_calloc
-#include "SDL3/SDL_timer.h"       // SDL_GetTicksNS
-#include <stdint.h>               // int64_t
+#include "SDL3/SDL_stdinc.h"      // SDL_clamp, SDL_free, SDL_calloc, SDL_qsort
+#include "SDL3/SDL_timer.h"       // SDL_DelayNS, SDL_GetTicksNS
+#include <stdint.h>               // int64_t, uint64_t
 #include <stdlib.h>               // exit
 
+// number of recent frame durations to keep for statistics
+#define TIMINGS_NFRAMES_HISTORY 512
+
+// bounds on how long before a frame deadline the pacer stops sleeping and starts spinning
+#define TIMINGS_SPIN_MAX 4000000              // nanoseconds
+#define TIMINGS_SPIN_MIN 200000               // nanoseconds
+
 // declare properties of `struct timings`
 struct timings {
     struct {
         int64_t tprev;                        // microseconds
         int64_t tthis;                        // microseconds
         float duration;                       // seconds
+        bool is_idle;                         // whether the frame waited for events, see timings_idle()
     } frame;
+    struct {
+        float durations[TIMINGS_NFRAMES_HISTORY];  // seconds, ring buffer
+        int inext;                            // where the next frame duration goes
+        int n;                                // number of valid frame durations
+    } history;
+    struct {
+        uint64_t deadline;                    // nanoseconds, when the current frame should end
+        uint64_t interval;                    // nanoseconds, or 0 if frames aren't paced
+        int nmissed;                          // deadlines that had passed before pacing started
+        uint64_t spin;                        // nanoseconds, sleep overshoot to make up for by spinning
+    } pace;
+    struct {
+        int64_t accumulator;                  // microseconds
+        int64_t duration;                     // microseconds
+        int nmax;                             // maximum number of ticks per frame
+        int64_t tthis;                        // microseconds, simulation clock
+    } tick;
 };
 
 // define pointer to singleton instance of `struct timings`
 static struct timings * singleton = nullptr;
 
+// forward declarations of functions defined below
+static int compare_float (const void * a, const void * b);
+
+static int compare_float (const void * a, const void * b) {
+    const float fa = *(const float *) a;
+    const float fb = *(const float *) b;
+    return (fa > fb) - (fa < fb);
+}
+
+void timings_advance (struct timings * self, int64_t duration) {
+    self->frame.tprev = self->frame.tthis;
+    self->frame.tthis += duration;  // microseconds
+    self->frame.duration = (float) duration / 1e6;
+
+    // remember the frame's duration for the statistics, unless most of it was spent waiting for
+    // events, which says nothing about how long frames take
+    if (self->frame.is_idle) {
+        self->frame.is_idle = false;
+    } else {
+        self->history.durations[self->history.inext] = self->frame.duration;
+        self->history.inext = (self->history.inext + 1) % TIMINGS_NFRAMES_HISTORY;
+        self->history.n = SDL_min(self->history.n + 1, TIMINGS_NFRAMES_HISTORY);
+    }
+
+    // bank the frame's duration for consumption by timings_tick(); after a long frame, drop
+    // whatever exceeds `nmax` ticks rather than trying to catch up and falling further behind
+    self->tick.accumulator = SDL_min(self->tick.accumulator + duration, self->tick.nmax * self->tick.duration);
+}
+
 void timings_delete (struct timings ** self) {
     SDL_free(*self);
     *self = nullptr;
@@ -27,18 +82,105 @@ float timings_get_frame_duration (const struct timings * self) {
     return self->frame.duration;
 }
 
+float timings_get_frame_duration_avg (const struct timings * self) {
+    if (self->history.n == 0) return 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < self->history.n; i++) {
+        sum += self->history.durations[i];
+    }
+    return sum / (float) self->history.n;
+}
+
+float timings_get_frame_duration_max (const struct timings * self) {
+    float max = 0.0f;
+    for (int i = 0; i < self->history.n; i++) {
+        max = SDL_max(max, self->history.durations[i]);
+    }
+    return max;
+}
+
+float timings_get_frame_duration_min (const struct timings * self) {
+    if (self->history.n == 0) return 0.0f;
+    float min = self->history.durations[0];
+    for (int i = 1; i < self->history.n; i++) {
+        min = SDL_min(min, self->history.durations[i]);
+    }
+    return min;
+}
+
+float timings_get_frame_duration_p99 (const struct timings * self) {
+    if (self->history.n == 0) return 0.0f;
+    float sorted[TIMINGS_NFRAMES_HISTORY];
+    SDL_memcpy(sorted, self->history.durations, self->history.n * sizeof(float));
+    SDL_qsort(sorted, self->history.n, sizeof(float), compare_float);
+    return sorted[(self->history.n - 1) * 99 / 100];
+}
+
+int timings_get_frame_durations (const struct timings * self, float * durations, int ndurations_cap) {
+    // copy the most recent frame durations, oldest first
+    const int n = SDL_min(self->history.n, ndurations_cap);
+    for (int i = 0; i < n; i++) {
+        const int j = (self->history.inext - n + i + TIMINGS_NFRAMES_HISTORY) % TIMINGS_NFRAMES_HISTORY;
+        durations[i] = self->history.durations[j];
+    }
+    return n;
+}
+
 int64_t timings_get_frame_timestamp (const struct timings * self) {
     return self->frame.tthis;
 }
 
+int timings_get_nmissed (const struct timings * self) {
+    return self->pace.nmissed;
+}
+
+float timings_get_tick_alpha (const struct timings * self) {
+    return (float) self->tick.accumulator / (float) self->tick.duration;
+}
+
+float timings_get_tick_duration (const struct timings * self) {
+    return (float) self->tick.duration / 1e6;
+}
+
+int64_t timings_get_tick_timestamp (const struct timings * self) {
+    return self->tick.tthis;
+}
+
+void timings_idle (struct timings * self) {
+    // the next frame's duration includes the wait, so leave it out of the statistics; and since
+    // its deadline has passed by then through no fault of the pacer, start the deadlines over
+    // rather than count a miss
+    self->frame.is_idle = true;
+    self->pace.deadline = 0;
+}
+
 void timings_init (struct timings * self) {
+    const int64_t tnow = (int64_t) (SDL_GetTicksNS() / 1000);  // microseconds
     *self = (struct timings) {
         .frame = {
             .duration = 0.0f,                              // seconds
-            .tprev = (int64_t) (SDL_GetTicksNS() / 1000),  // microseconds
-            .tthis = (int64_t) (SDL_GetTicksNS() / 1000),  // microseconds
+            .is_idle = false,
+            .tprev = tnow,                                 // microseconds
+            .tthis = tnow,                                 // microseconds
+        },
+        .history = {
+            .inext = 0,
+            .n = 0,
+        },
+        .pace = {
+            .deadline = 0,                                 // nanoseconds
+            .interval = 0,                                 // nanoseconds, i.e. not paced
+            .nmissed = 0,
+            .spin = 1000000,                               // nanoseconds
+        },
+        .tick = {
+            .accumulator = (int64_t) 0,                    // microseconds
+            .duration = (int64_t) 0,                       // microseconds, set below
+            .nmax = 8,
+            .tthis = tnow,                                 // microseconds
         },
     };
+    timings_set_tick_rate(self, 120);
 }
 
 struct timings * timings_new (void) {
@@ -56,8 +198,71 @@ struct timings * timings_new (void) {
     return singleton;
 }
 
+void timings_pace (struct timings * self) {
+    if (self->pace.interval == 0) return;
+
+    // deadlines follow each other at a fixed interval, such that an early frame doesn't shift the
+    // ones after it; after a miss, start over from now rather than rushing to catch up
+    const uint64_t tnow = SDL_GetTicksNS();
+    self->pace.deadline += self->pace.interval;
+    if (tnow >= self->pace.deadline) {
+        if (self->pace.deadline > self->pace.interval) {
+            // not counting the first frame, which has no previous deadline to follow
+            self->pace.nmissed++;
+        }
+        self->pace.deadline = tnow;
+        return;
+    }
+
+    // sleep coarsely, leaving a margin for the OS waking up late, then spin for the rest; the
+    // margin follows the oversleep that was observed, quickly up and slowly down
+    const uint64_t remaining = self->pace.deadline - tnow;
+    if (remaining > self->pace.spin) {
+        const uint64_t requested = remaining - self->pace.spin;
+        SDL_DelayNS(requested);
+        const uint64_t slept = SDL_GetTicksNS() - tnow;
+        const uint64_t oversleep = slept > requested ? slept - requested : 0;
+        if (oversleep > self->pace.spin) {
+            self->pace.spin = oversleep;
+        } else {
+            self->pace.spin -= (self->pace.spin - oversleep) / 16;
+        }
+        self->pace.spin = SDL_clamp(self->pace.spin, TIMINGS_SPIN_MIN, TIMINGS_SPIN_MAX);
+    }
+    while (SDL_GetTicksNS() < self->pace.deadline) {
+        SDL_CPUPauseInstruction();
+    }
+}
+
+void timings_set_target_rate (struct timings * self, int rate) {
+    if (rate < 0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Target frame rate should be positive, or 0 to not pace frames, aborting.\n");
+        exit(1);
+    }
+    self->pace.deadline = 0;
+    self->pace.interval = rate > 0 ? (uint64_t) 1000000000 / (uint64_t) rate : 0;
+}
+
+void timings_set_tick_rate (struct timings * self, int rate) {
+    if (rate <= 0) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "Tick rate should be positive, aborting.\n");
+        exit(1);
+    }
+    self->tick.duration = (int64_t) 1000000 / rate;
+}
+
+bool timings_tick (struct timings * self) {
+    if (self->tick.accumulator < self->tick.duration) {
+        return false;
+    }
+    self->tick.accumulator -= self->tick.duration;
+    self->tick.tthis += self->tick.duration;
+    return true;
+}
+
 void timings_update (struct timings * self) {
-    self->frame.tprev = self->frame.tthis;
-    self->frame.tthis = (int64_t) (SDL_GetTicksNS() / 1000); // microseconds
-    self->frame.duration = (float) (self->frame.tthis - self->frame.tprev) / 1e6;
+    const int64_t tnow = (int64_t) (SDL_GetTicksNS() / 1000); // microseconds
+    timings_advance(self, tnow - self->frame.tthis);
 }
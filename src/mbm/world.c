@@ -1,18 +1,24 @@
 #include "mbm/world.h"
+#include "atlas.h"                // struct atlas, atlas_get_rect, atlas_get_texture
+#include "bvh.h"                  // struct bvh and associated functions
+#include "camera.h"               // struct camera, camera_get_offset, camera_get_view
+#include "chunks.h"               // struct chunks and associated functions, CHUNKS_SIZE
+#include "collisions.h"           // collisions_resolve_penetration, collisions_sweep_aabb
 #include "mbm/dims.h"             // struct dims
-#include "mbm/timings.h"          // struct timings and associated functions
-#include "idx/idx.h"              // functionality related to reading binary data from file
+#include "profiler.h"             // MBM_PROFILE_SCOPE
+#include "sprites.h"              // struct sprites, sprites_push_outline, sprites_push_quads_translated, SPRITES_LAYER_*
 #include "SDL3/SDL_error.h"       // SDL_GetError
 #include "SDL3/SDL_filesystem.h"  // SDL_GetBasePath
+#include "SDL3/SDL_iostream.h"    // SDL_LoadFile
 #include "SDL3/SDL_log.h"         // SDL_LogCritical
-#include "SDL3/SDL_rect.h"        // SDL_FRect
-#include "SDL3/SDL_render.h"      // SDL_Renderer, SDL_Texture, SDL_CreateTextureFromSurface, SDL_DestroyTexture, SDL_RenderTexture
-#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_free
-#include "SDL3/SDL_surface.h"     // SDL_Surface, SDL_LoadBMP, SDL_DestroySurface
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_pixels.h"      // SDL_FColor
+#include "SDL3/SDL_render.h"      // SDL_Texture, SDL_Vertex
+#include "SDL3/SDL_stdinc.h"      // SDL_asprintf, SDL_calloc, SDL_floorf, SDL_free, SDL_isspace, SDL_memset, SDL_realloc, SDL_strtod
 #include <assert.h>               // assert
 #include <stdint.h>               // uint8_t
 #include <stdlib.h>               // exit
-#include <sys/param.h>            // MIN
+#include <sys/param.h>            // MAX, MIN
 
 typedef enum : uint8_t {
     TILE_TYPE_AIR = 0,
@@ -23,149 +29,327 @@ typedef enum : uint8_t {
 
 // declare properties of `struct world`
 struct world {
+    struct {
+        int icol_e;   // end of the tile columns that are in the ring (exclusive)
+        int icol_s;   // start of the tile columns that are in the ring
+        int irow_s;   // tile row of the first quad in each column slot
+        int ncols;    // column slots
+        int nrows;    // quads per column slot
+        SDL_Vertex * vertices;
+    } batch;
     SDL_FRect bbox;
+    struct bvh * bvh;       // hierarchy over `colliders`, for finding the ones near a box
+    struct chunks * chunks;
+    SDL_FRect * colliders;  // solid tiles merged into rectangles, plus the level's other shapes, in pixels
     float gravity;  // pixels per second per second
     int h;
+    int ncolliders;
+    int ncolliders_cap;
     int ncols;
     int nrows;
     struct {
         int h;
-        SDL_Texture * texture;
+        SDL_Texture * texture;  // the atlas' texture
         SDL_FRect srcs[TILE_TYPE_COUNT];
-        TileType ** types;
+        SDL_FRect uvs[TILE_TYPE_COUNT];
         int w;
     } tile;
-    struct {
-        int dx;       // pixels per second
-        int h;
-        int w;
-        float x;
-        float y;
-    } view;
     int w;
 };
 
+#ifdef MBM_DRAW_BBOXES
+// what outline_collider() needs to draw a collider's outline in view coordinates
+struct outline {
+    SDL_FPoint offset;
+    struct sprites * sprites;
+};
+#endif // MBM_DRAW_BBOXES
+
 // forward declaration of static functions
-static TileType ** allocate_tiles (int nrows, int ncols);
-static SDL_Texture * load_tile_texture (const char * relpath, SDL_Renderer * renderer);
-static void load_tile_map (const char * relpath, uint32_t nrows, uint32_t ncols, uint8_t * bufffer);
+static void add_collider (struct world * self, SDL_FRect collider);
+static void allocate_batch (struct world * self, const struct dims * dims);
+static void build_column (struct world * self, int icol);
+static void clear_column (struct world * self, int icol);
+static SDL_Vertex * get_column (const struct world * self, int icol);
+static void get_view_range (const struct world * self, SDL_FRect view, int * icol_s, int * icol_e, int * irow_s, int * irow_e);
+static bool is_solid (const struct world * self, int irow, int icol);
+static void load_colliders (struct world * self, const char * relpath);
+static void merge_colliders (struct world * self);
+#ifdef MBM_DRAW_BBOXES
+static bool outline_collider (SDL_FRect collider, void * userdata);
+#endif // MBM_DRAW_BBOXES
 
 // define pointer to singleton instance of `struct world`
 static struct world * singleton = nullptr;
 
-static TileType ** allocate_tiles (const int nrows, const int ncols) {
-    TileType * mem = (TileType *) SDL_calloc(nrows * ncols, sizeof(TileType));
-    if (mem == nullptr) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Error allocating dynamic memory for contiguous memory for tile types, aborting; %s\n",
-                        SDL_GetError());
-        exit(1);
+static void add_collider (struct world * self, SDL_FRect collider) {
+    if (self->ncolliders == self->ncolliders_cap) {
+        const int ncolliders_cap = self->ncolliders_cap > 0 ? 2 * self->ncolliders_cap : 64;
+        SDL_FRect * colliders = (SDL_FRect *) SDL_realloc(self->colliders, ncolliders_cap * sizeof(SDL_FRect));
+        if (colliders == nullptr) {
+            SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                            "Error allocating dynamic memory for colliders, aborting; %s\n",
+                            SDL_GetError());
+            exit(1);
+        }
+        self->colliders = colliders;
+        self->ncolliders_cap = ncolliders_cap;
     }
-    TileType ** tile_types = (TileType **) SDL_calloc(nrows, sizeof(TileType *));
-    if (tile_types == nullptr) {
+    self->colliders[self->ncolliders] = collider;
+    self->ncolliders++;
+}
+
+static void allocate_batch (struct world * self, const struct dims * dims) {
+    // the batch is a ring of column slots, each holding the quads of one tile column; when the
+    // view is not aligned with the tile grid, it straddles one extra column and row
+    const int ncols = dims->view.w / dims->tile.w + 1;
+    const int nrows = dims->view.h / dims->tile.h + 1;
+    SDL_Vertex * vertices = (SDL_Vertex *) SDL_calloc(4 * ncols * nrows, sizeof(SDL_Vertex));
+    if (vertices == nullptr) {
         SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Error allocating dynamic memory for memory for tile types, aborting; %s\n",
+                        "Error allocating dynamic memory for tile vertices, aborting; %s\n",
                         SDL_GetError());
         exit(1);
     }
-    for (int irow = 0; irow < nrows; ++irow) {
-        tile_types[irow] = &mem[irow * ncols];
-    }
-    return tile_types;
+
+    // start out without any columns; all quads are degenerate, since their vertices coincide
+    self->batch.icol_e = 0;
+    self->batch.icol_s = 0;
+    self->batch.irow_s = 0;
+    self->batch.ncols = ncols;
+    self->batch.nrows = nrows;
+    self->batch.vertices = vertices;
 }
 
-static SDL_Texture * load_tile_texture (const char * relpath, SDL_Renderer * renderer) {
+static void build_column (struct world * self, int icol) {
+    const SDL_FColor white = (SDL_FColor) {
+        .r = 1.0f,
+        .g = 1.0f,
+        .b = 1.0f,
+        .a = 1.0f,
+    };
 
-    // create surface given relative path
-    char * path = nullptr;
-    SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
-    SDL_Surface * surface = SDL_LoadBMP(path);
-    if (surface == nullptr) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Couldn't load tiles bitmap, aborting; %s\n",
-                        SDL_GetError());
-        exit(1);
+    // the quads are in world coordinates, so they stay valid for as long as the column is in
+    // view; air, and rows outside of the level, get a degenerate quad that covers no pixels.
+    // Unlike the colliders, the quads aren't merged into runs: a merged quad would have to repeat
+    // its tile's source, but the tiles are regions of the atlas, and texture coordinates can only
+    // wrap around a whole texture. The ring already limits the quads to the tiles in view.
+    clear_column(self, icol);
+    SDL_Vertex * column = get_column(self, icol);
+    const int irow_s = MAX(self->batch.irow_s, 0);
+    const int irow_e = MIN(self->batch.irow_s + self->batch.nrows, self->nrows);
+    for (int irow = irow_s; irow < irow_e; irow++) {
+        TileType t = (TileType) chunks_get_tile(self->chunks, irow, icol);
+        if (t == TILE_TYPE_AIR) continue;
+        const SDL_FRect uv = self->tile.uvs[t];
+        const float x0 = (float) (icol * self->tile.w);
+        const float x1 = x0 + (float) self->tile.w;
+        const float y0 = (float) (irow * self->tile.h);
+        const float y1 = y0 + (float) self->tile.h;
+        SDL_Vertex * v = &column[4 * (irow - self->batch.irow_s)];
+        v[0] = (SDL_Vertex) { .position = { x0, y0 }, .color = white, .tex_coord = { uv.x, uv.y } };
+        v[1] = (SDL_Vertex) { .position = { x1, y0 }, .color = white, .tex_coord = { uv.x + uv.w, uv.y } };
+        v[2] = (SDL_Vertex) { .position = { x1, y1 }, .color = white, .tex_coord = { uv.x + uv.w, uv.y + uv.h } };
+        v[3] = (SDL_Vertex) { .position = { x0, y1 }, .color = white, .tex_coord = { uv.x, uv.y + uv.h } };
     }
+}
 
-    // create texture from surface
-    SDL_Texture * texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "Couldn't create texture for tiles, aborting; %s\n",
-                        SDL_GetError());
-        exit(1);
-    }
+static void clear_column (struct world * self, int icol) {
+    SDL_memset(get_column(self, icol), 0, 4 * self->batch.nrows * sizeof(SDL_Vertex));
+}
 
-    // set texture scale mode
-    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+static SDL_Vertex * get_column (const struct world * self, int icol) {
+    // consecutive columns take consecutive slots, wrapping around at the end of the ring
+    const int islot = icol % self->batch.ncols;
+    return &self->batch.vertices[4 * islot * self->batch.nrows];
+}
 
-    // free dynamically allocated memory used by surface and by path
-    SDL_DestroySurface(surface);
-    surface = nullptr;
-    SDL_free(path);
-    path = nullptr;
+static void get_view_range (const struct world * self, SDL_FRect view, int * icol_s, int * icol_e, int * irow_s, int * irow_e) {
+    // find the (half-open) range of tile columns and rows that the view overlaps, clipped to the
+    // level; when the view is not aligned with the tile grid, it straddles one extra column and row
+    const int icol = (int) SDL_floorf(view.x / self->tile.w);
+    const int irow = (int) SDL_floorf(view.y / self->tile.h);
+    *icol_s = MAX(icol, 0);
+    *icol_e = MIN(icol + (int) view.w / self->tile.w + 1, self->ncols);
+    *irow_s = MAX(irow, 0);
+    *irow_e = MIN(irow + (int) view.h / self->tile.h + 1, self->nrows);
+}
 
-    // return texture
-    return texture;
+static bool is_solid (const struct world * self, int irow, int icol) {
+    return chunks_get_tile(self->chunks, irow, icol) != TILE_TYPE_AIR;
 }
 
-static void load_tile_map (const char * relpath, uint32_t nrows, uint32_t ncols, uint8_t * buffer) {
+static void load_colliders (struct world * self, const char * relpath) {
+    // a level may come with a list of colliders that aren't on the tile grid, e.g. floating
+    // platforms; it's a text file with one collider per line, as `x y w h` in pixels, where empty
+    // lines and lines that start with '#' are skipped. Levels without such shapes have no list.
     char * path = nullptr;
     SDL_asprintf(&path, "%s%s", SDL_GetBasePath(), relpath);
-    const IdxHeader header = idx_read_header(path);
-    if (header.lengths[0] != nrows) {
-        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "number of rows in tile map should be equal to number of rows in tilemap file, aborting.\n");
-        exit(1);
+    size_t size = 0;
+    char * text = (char *) SDL_LoadFile(path, &size);
+    if (text == nullptr) {
+        SDL_free(path);
+        return;
     }
-    if (header.lengths[1] != ncols) {
+    // SDL_LoadFile() terminates the text with a null byte, so the last line ends in one either way
+    int iline = 1;
+    for (char * line = text; line < text + size; iline++) {
+        char * eol = line;
+        while (eol < text + size && *eol != '\n') {
+            eol++;
+        }
+        *eol = '\0';
+        char * p = line;
+        while (SDL_isspace(*p)) {
+            p++;
+        }
+        if (*p != '\0' && *p != '#') {
+            float values[4] = {};
+            for (int i = 0; i < 4; i++) {
+                char * end = nullptr;
+                values[i] = (float) SDL_strtod(p, &end);
+                if (end == p) {
+                    values[3] = 0.0f;
+                    break;
+                }
+                p = end;
+            }
+            while (SDL_isspace(*p)) {
+                p++;
+            }
+            if (!(values[2] > 0.0f && values[3] > 0.0f) || *p != '\0') {
+                SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                                "Line %d of collider list '%s' isn't a collider as 'x y w h' with a positive size, aborting.\n",
+                                iline, path);
+                SDL_free(text);
+                SDL_free(path);
+                exit(1);
+            }
+            add_collider(self, (SDL_FRect) {
+                .h = values[3],
+                .w = values[2],
+                .x = values[0],
+                .y = values[1],
+            });
+        }
+        line = eol + 1;
+    }
+    SDL_free(text);
+    SDL_free(path);
+}
+
+static void merge_colliders (struct world * self) {
+
+    // the level is walled in on the left and right, but open at the top and bottom; the walls
+    // reach a level's height beyond the top and the bottom, such that ducks that jump or fall out
+    // of the level still don't pass them
+    const float h = (float) self->h;
+    const float w = (float) self->tile.w;
+    add_collider(self, (SDL_FRect) { .h = 3.0f * h, .w = w, .x = -w, .y = -h });
+    add_collider(self, (SDL_FRect) { .h = 3.0f * h, .w = w, .x = (float) self->w, .y = -h });
+
+    // merge the solid tiles greedily into rectangles: start a rectangle at the first solid tile
+    // in reading order that isn't covered yet, widen it along its row for as long as the tiles
+    // are solid, then grow it downward for as long as the row below is solid across its width.
+    bool * is_covered = (bool *) SDL_calloc((size_t) self->nrows * self->ncols, sizeof(bool));
+    if (is_covered == nullptr) {
         SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
-                        "number of columns in tile map should be equal to number of columns in tilemap file, aborting.\n");
+                        "Error allocating dynamic memory for merging colliders, aborting; %s\n",
+                        SDL_GetError());
         exit(1);
     }
-    idx_read_body_as_uint8(path, &header, buffer);
-    SDL_free(path);
-    path = nullptr;
+    for (int irow = 0; irow < self->nrows; irow++) {
+        for (int icol = 0; icol < self->ncols; icol++) {
+            if (is_covered[irow * self->ncols + icol] || !is_solid(self, irow, icol)) continue;
+            int icol_e = icol + 1;
+            while (icol_e < self->ncols && !is_covered[irow * self->ncols + icol_e] && is_solid(self, irow, icol_e)) {
+                icol_e++;
+            }
+            int irow_e = irow + 1;
+            bool is_full = true;
+            while (is_full && irow_e < self->nrows) {
+                for (int i = icol; i < icol_e; i++) {
+                    if (is_covered[irow_e * self->ncols + i] || !is_solid(self, irow_e, i)) {
+                        is_full = false;
+                        break;
+                    }
+                }
+                if (is_full) {
+                    irow_e++;
+                }
+            }
+            for (int r = irow; r < irow_e; r++) {
+                for (int c = icol; c < icol_e; c++) {
+                    is_covered[r * self->ncols + c] = true;
+                }
+            }
+            add_collider(self, (SDL_FRect) {
+                .h = (float) ((irow_e - irow) * self->tile.h),
+                .w = (float) ((icol_e - icol) * self->tile.w),
+                .x = (float) (icol * self->tile.w),
+                .y = (float) (irow * self->tile.h),
+            });
+        }
+    }
+    SDL_free(is_covered);
+}
+
+#ifdef MBM_DRAW_BBOXES
+static bool outline_collider (SDL_FRect collider, void * userdata) {
+    const struct outline * outline = (const struct outline *) userdata;
+    const SDL_FRect rect = (SDL_FRect) {
+        .h = collider.h,
+        .w = collider.w,
+        .x = collider.x + outline->offset.x,
+        .y = collider.y + outline->offset.y,
+    };
+    sprites_push_outline(outline->sprites, SPRITES_LAYER_BBOXES, rect, (SDL_FColor) { 1.0f, 0.5f, 0.0f, 1.0f });
+    return true;
 }
+#endif // MBM_DRAW_BBOXES
 
 void world_delete (struct world ** self) {
-    // free dynamically allocated memory used by .texture
-    SDL_DestroyTexture((*self)->tile.texture);
-    (*self)->tile.texture = nullptr;
+    // free memory holding the tile batch
+    SDL_free((*self)->batch.vertices);
+    (*self)->batch.vertices = nullptr;
 
-    // free memory holding the contiguous tile type data
-    SDL_free((*self)->tile.types[0]);
-    (*self)->tile.types[0] = nullptr;
+    // free memory holding the colliders and the hierarchy over them
+    bvh_delete(&(*self)->bvh);
+    SDL_free((*self)->colliders);
+    (*self)->colliders = nullptr;
 
-    // free memory holding the row/column tile type data
-    SDL_free((*self)->tile.types);
-    (*self)->tile.types = nullptr;
+    // the texture belongs to the atlas
+    (*self)->tile.texture = nullptr;
+
+    // unmap the tile map file
+    chunks_delete(&(*self)->chunks);
 
     // free own resources
     SDL_free(*self);
     *self = nullptr;
 }
 
-void world_draw (const struct world * self, SDL_Renderer * renderer) {
-    int icol_s = self->view.x / self->tile.w;
-    int icol_e = MIN(self->view.x + self->view.w / self->tile.w + 1, self->ncols);
-    for (int irow = 0; irow < self->nrows; irow++) {
-        for (int icol = icol_s; icol < icol_e; icol++) {
-            TileType t = self->tile.types[irow][icol];
-            if (t == TILE_TYPE_AIR) continue;
-            SDL_FRect src = self->tile.srcs[t];
-            SDL_FRect wld = {
-                .h = (float) (self->tile.h),
-                .w = (float) (self->tile.w),
-                .x = (float) (icol * self->tile.w) - self->view.x,
-                .y = (float) (irow * self->tile.h),
-            };
-            SDL_RenderTexture(renderer, self->tile.texture, &src, &wld);
-        }
-    }
+void world_draw (const struct world * self, struct sprites * sprites, const struct camera * camera) {
+    MBM_PROFILE_SCOPE("world_draw");
+
+    // hand over all column slots in one go, as prepared by world_update(), moving them from world
+    // into view coordinates on the way
+    const SDL_FPoint offset = camera_get_offset(camera);
+    const int nquads = self->batch.ncols * self->batch.nrows;
+    sprites_push_quads_translated(sprites, SPRITES_LAYER_WORLD, self->tile.texture, self->batch.vertices, nquads, offset);
 #ifdef MBM_DRAW_BBOXES
-    SDL_SetRenderDrawColor (renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-    SDL_RenderRect(renderer, &self->bbox);
+    const SDL_FRect bbox = (SDL_FRect) {
+        .h = self->bbox.h,
+        .w = self->bbox.w,
+        .x = self->bbox.x + offset.x,
+        .y = self->bbox.y + offset.y,
+    };
+    sprites_push_outline(sprites, SPRITES_LAYER_BBOXES, bbox, (SDL_FColor) { 1.0f, 1.0f, 1.0f, 1.0f });
+    struct outline outline = (struct outline) {
+        .offset = offset,
+        .sprites = sprites,
+    };
+    bvh_visit_aabb(self->bvh, camera_get_view(camera), outline_collider, &outline);
 #endif // MBM_DRAW_BBOXES
 }
 
@@ -177,28 +361,27 @@ float world_get_gravity (const struct world * self) {
     return self->gravity;
 }
 
-void world_init (struct world * self, SDL_Renderer * renderer, const struct dims * dims) {
-    int nrows = dims->view.h / dims->tile.h;
-    int ncols = dims->wld.w / dims->tile.w;
-
-    // load the tile index into a texture 
-    SDL_Texture * texture = load_tile_texture("../share/mbm/assets/images/tiles.bmp", renderer);
-
-    // allocate memory for accessing the tiles consecutively and by row/col
-    TileType ** tile_types = allocate_tiles(nrows, ncols);
+void world_init (struct world * self, const struct atlas * atlas, const struct dims * dims) {
+    // the tile index is one of the sprite sheets in the atlas
+    SDL_Texture * texture = atlas_get_texture(atlas);
+    const SDL_FRect sheet = atlas_get_rect(atlas, "tiles", false);
 
-    // initialize a tile pattern by loading from file
-    load_tile_map("../share/mbm/assets/tilemaps/level1.idx", nrows, ncols, tile_types[0]);
+    // map the tile pattern from file; its pages are read in on demand, so the level's size
+    // follows from the file's header rather than from `dims`
+    struct chunks * chunks = chunks_new("../share/mbm/assets/tilemaps/level1.idx");
+    const int nrows = chunks_get_nrows(chunks);
+    const int ncols = chunks_get_ncols(chunks);
 
     *self = (struct world) {
         .bbox = (SDL_FRect) {
-            .h = dims->tile.h,
-            .w = 4 * dims->tile.w,
-            .x = 12 * dims->tile.w,
-            .y = 5 * dims->tile.h,
+            .h = (float) (nrows * dims->tile.h),
+            .w = (float) (ncols * dims->tile.w),
+            .x = 0.0f,
+            .y = 0.0f,
         },
+        .chunks = chunks,
         .gravity = 10.0f,  // pixels per s per s
-        .h = dims->wld.h,
+        .h = nrows * dims->tile.h,
         .ncols = ncols,
         .nrows = nrows,
         .tile = {
@@ -208,34 +391,57 @@ void world_init (struct world * self, SDL_Renderer * renderer, const struct dims
                 [TILE_TYPE_AIR] = (SDL_FRect) {
                     .h = (float) (dims->tile.h),
                     .w = (float) (dims->tile.w),
-                    .x = 0 * (32.0f + 2.0f) + 1.0f,
-                    .y = 1.0f,
+                    .x = sheet.x + 0 * (32.0f + 2.0f) + 1.0f,
+                    .y = sheet.y + 1.0f,
                 },
                 [TILE_TYPE_GROUND] = (SDL_FRect) {
                     .h = (float) (dims->tile.h),
                     .w = (float) (dims->tile.w),
-                    .x = 1 * (32.0f + 2.0f) + 1.0f,
-                    .y = 1.0f,
+                    .x = sheet.x + 1 * (32.0f + 2.0f) + 1.0f,
+                    .y = sheet.y + 1.0f,
                 },
                 [TILE_TYPE_BRICK_WALL] = (SDL_FRect) {
                     .h = (float) (dims->tile.h),
                     .w = (float) (dims->tile.w),
-                    .x = 2 * (32.0f + 2.0f) + 1.0f,
-                    .y = 1.0f,
+                    .x = sheet.x + 2 * (32.0f + 2.0f) + 1.0f,
+                    .y = sheet.y + 1.0f,
                 },
             },
-            .types = tile_types,
             .w = dims->tile.w,
         },
-        .view = {
-            .dx = 50.3,
-            .h = dims->view.h,
-            .w = dims->view.w,
-            .x = 0.0f,
-            .y = 0.0f,
-        },
-        .w = dims->wld.w,
+        .w = ncols * dims->tile.w,
     };
+
+    // express the tile sources as texture coordinates, for use in the tile batch
+    {
+        float texture_h = 0.0f;
+        float texture_w = 0.0f;
+        SDL_GetTextureSize(texture, &texture_w, &texture_h);
+        for (int t = 0; t < TILE_TYPE_COUNT; t++) {
+            const SDL_FRect src = self->tile.srcs[t];
+            self->tile.uvs[t] = (SDL_FRect) {
+                .h = src.h / texture_h,
+                .w = src.w / texture_w,
+                .x = src.x / texture_w,
+                .y = src.y / texture_h,
+            };
+        }
+    }
+
+    // collide with few large rectangles rather than with every solid tile, plus the shapes off the
+    // tile grid, and organize them such that finding the ones near a duck takes logarithmic rather
+    // than linear time
+    merge_colliders(self);
+    load_colliders(self, "../share/mbm/assets/tilemaps/level1.colliders");
+    self->bvh = bvh_new(self->colliders, self->ncolliders);
+
+    // the column slots are filled by world_update(), once it knows where the camera is
+    allocate_batch(self, dims);
+}
+
+SDL_FPoint world_resolve_penetration (const struct world * self, SDL_FRect aabb) {
+    // how far to move `aabb` such that it no longer overlaps any collider
+    return collisions_resolve_penetration(self->bvh, aabb);
 }
 
 struct world * world_new (void) {
@@ -253,7 +459,51 @@ struct world * world_new (void) {
     return singleton;
 }
 
-void world_update (struct world * self, const struct timings * timings) {
-    (void) self;
-    (void) timings;
+float world_sweep_aabb (const struct world * self, SDL_FRect aabb, SDL_FPoint delta, SDL_FPoint * normal) {
+    // how far `aabb` can move along `delta` before it hits a collider, as a fraction of `delta`
+    return collisions_sweep_aabb(self->bvh, aabb, delta, normal);
+}
+
+void world_update (struct world * self, const struct camera * camera) {
+    MBM_PROFILE_SCOPE("world_update");
+    int icol_s, icol_e, irow_s, irow_e;
+    get_view_range(self, camera_get_view(camera), &icol_s, &icol_e, &irow_s, &irow_e);
+
+    // read ahead the chunks around the view, including a chunk of margin on every side, such
+    // that the next ones are in memory before the view reaches them
+    chunks_prefetch(self->chunks, irow_s - CHUNKS_SIZE, irow_e + CHUNKS_SIZE,
+                    icol_s - CHUNKS_SIZE, icol_e + CHUNKS_SIZE);
+
+    // every column slot starts at the view's first row, so scrolling vertically past a row
+    // boundary invalidates all of them; that only happens in levels taller than the view
+    if (irow_s != self->batch.irow_s) {
+        for (int icol = self->batch.icol_s; icol < self->batch.icol_e; icol++) {
+            clear_column(self, icol);
+        }
+        self->batch.icol_e = 0;
+        self->batch.icol_s = 0;
+        self->batch.irow_s = irow_s;
+    }
+
+    // only touch the columns that left or entered the view since the last update, which makes
+    // scrolling cost proportional to the number of columns crossed rather than to the view's
+    // size; a column that entered reuses the slot of one that left. The quads are in world
+    // coordinates, so subpixel movement of the camera doesn't change any of them.
+    for (int icol = self->batch.icol_s; icol < self->batch.icol_e; icol++) {
+        if (icol >= icol_s && icol < icol_e) {
+            // skip the columns that are still in view
+            icol = icol_e - 1;
+            continue;
+        }
+        clear_column(self, icol);
+    }
+    for (int icol = icol_s; icol < icol_e; icol++) {
+        if (icol >= self->batch.icol_s && icol < self->batch.icol_e) {
+            icol = self->batch.icol_e - 1;
+            continue;
+        }
+        build_column(self, icol);
+    }
+    self->batch.icol_e = icol_e;
+    self->batch.icol_s = icol_s;
 }
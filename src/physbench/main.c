@@ -0,0 +1,95 @@
+#include "physics.h"              // struct physics_bodies, enum physics_kernel and associated functions
+#include "SDL3/SDL_error.h"       // SDL_GetError
+#include "SDL3/SDL_log.h"         // SDL_Log, SDL_LogCritical
+#include "SDL3/SDL_stdinc.h"      // SDL_calloc, SDL_free, SDL_memcmp
+#include "SDL3/SDL_timer.h"       // SDL_GetTicksNS
+#include <stdlib.h>               // exit
+
+// number of arrays in struct physics_bodies
+#define NARRAYS 8
+
+// forward declaration of static functions
+static float * allocate (int n);
+static void reset (float * arrays[NARRAYS], int n);
+static double run (enum physics_kernel kernel, float * arrays[NARRAYS], int n, int nsteps);
+
+static float * allocate (int n) {
+    float * mem = (float *) SDL_calloc(n, sizeof(float));
+    if (mem == nullptr) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_ERROR,
+                        "ERROR allocating dynamic memory for bodies, aborting; %s\n",
+                        SDL_GetError());
+        exit(1);
+    }
+    return mem;
+}
+
+static void reset (float * arrays[NARRAYS], int n) {
+    // spread the bodies over the level with a mix of velocities, the same way every time
+    for (int i = 0; i < n; i++) {
+        arrays[0][i] = (float) (i % 960) + 12.0f;             // bbox x
+        arrays[1][i] = (float) (i % 288) + 9.0f;              // bbox y
+        arrays[2][i] = 0.0f;                                  // previous x
+        arrays[3][i] = 0.0f;                                  // previous y
+        arrays[4][i] = (float) (i % 960);                     // x
+        arrays[5][i] = (float) (i % 288);                     // y
+        arrays[6][i] = (float) (i % 3 - 1) * 20.0f;           // horizontal speed
+        arrays[7][i] = (float) (i % 7) * -50.0f;              // vertical speed
+    }
+}
+
+static double run (enum physics_kernel kernel, float * arrays[NARRAYS], int n, int nsteps) {
+    const struct physics_bodies bodies = (struct physics_bodies) {
+        .bbox_x = arrays[0],
+        .bbox_y = arrays[1],
+        .n = n,
+        .pos_prev_x = arrays[2],
+        .pos_prev_y = arrays[3],
+        .pos_x = arrays[4],
+        .pos_y = arrays[5],
+        .vx = arrays[6],
+        .vy = arrays[7],
+    };
+    reset(arrays, n);
+    const Uint64 tstart = SDL_GetTicksNS();
+    for (int istep = 0; istep < nsteps; istep++) {
+        physics_integrate_with(kernel, &bodies, 1.0f / 120, 9.81f * 32, 250.0f);
+    }
+    return (double) (SDL_GetTicksNS() - tstart) / nsteps / n;
+}
+
+int main (void) {
+    static const int ns[] = { 1000, 10000, 100000 };
+    const enum physics_kernel best = physics_get_best_kernel();
+
+    // simulate the same total number of body updates for every population size
+    const int nupdates = 100000000;
+
+    for (int in = 0; in < (int) SDL_arraysize(ns); in++) {
+        const int n = ns[in];
+        float * expected[NARRAYS] = {};
+        float * actual[NARRAYS] = {};
+        for (int iarray = 0; iarray < NARRAYS; iarray++) {
+            expected[iarray] = allocate(n);
+            actual[iarray] = allocate(n);
+        }
+        const double t_scalar = run(PHYSICS_KERNEL_SCALAR, expected, n, nupdates / n);
+        SDL_Log("physbench: %6d bodies, %-6s %7.3f ns/body\n", n,
+                physics_get_kernel_name(PHYSICS_KERNEL_SCALAR), t_scalar);
+        for (int kernel = PHYSICS_KERNEL_SCALAR + 1; kernel <= (int) best; kernel++) {
+            const double t = run((enum physics_kernel) kernel, actual, n, nupdates / n);
+            bool agrees = true;
+            for (int iarray = 0; iarray < NARRAYS; iarray++) {
+                agrees = agrees && SDL_memcmp(expected[iarray], actual[iarray], n * sizeof(float)) == 0;
+            }
+            SDL_Log("physbench: %6d bodies, %-6s %7.3f ns/body, %5.2fx speedup%s\n", n,
+                    physics_get_kernel_name((enum physics_kernel) kernel), t, t_scalar / t,
+                    agrees ? "" : ", RESULTS DIFFER FROM SCALAR");
+        }
+        for (int iarray = 0; iarray < NARRAYS; iarray++) {
+            SDL_free(expected[iarray]);
+            SDL_free(actual[iarray]);
+        }
+    }
+    return 0;
+}
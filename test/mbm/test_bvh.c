@@ -0,0 +1,179 @@
+#include "bvh.h"
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include "SDL3/SDL_stdinc.h"      // SDL_max, SDL_min
+#include <criterion/criterion.h>
+#include <float.h>                // FLT_MAX
+#include <stdint.h>               // uint32_t
+
+#define TEST_BVH_NRECTS 5000
+#define TEST_BVH_NQUERIES 500
+
+// what count_rect() has seen of the rectangles that a query visited
+struct visits {
+    int n;
+    int nstop;                                // stop the query after this many, or 0 to not stop
+    double sum;                               // of the rectangles' coordinates, to tell sets apart
+};
+
+static bool count_rect (SDL_FRect rect, void * userdata);
+static bool is_overlapping (SDL_FRect a, SDL_FRect b);
+static float random_float (uint32_t * state, float lo, float hi);
+static SDL_FRect random_rect (uint32_t * state, float extent, float size_max);
+static bool slab_ray (SDL_FRect rect, SDL_FPoint origin, SDL_FPoint direction, float tmax, float * t);
+
+static bool count_rect (SDL_FRect rect, void * userdata) {
+    struct visits * visits = (struct visits *) userdata;
+    visits->n++;
+    visits->sum += rect.x + 3.0 * rect.y + 5.0 * rect.w + 7.0 * rect.h;
+    return visits->nstop == 0 || visits->n < visits->nstop;
+}
+
+static bool is_overlapping (SDL_FRect a, SDL_FRect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static float random_float (uint32_t * state, float lo, float hi) {
+    // xorshift32, such that the rectangles are the same on every platform and every run
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return lo + (hi - lo) * (float) (*state >> 8) / (float) (1u << 24);
+}
+
+static SDL_FRect random_rect (uint32_t * state, float extent, float size_max) {
+    return (SDL_FRect) {
+        .h = random_float(state, 1.0f, size_max),
+        .w = random_float(state, 1.0f, size_max),
+        .x = random_float(state, 0.0f, extent),
+        .y = random_float(state, 0.0f, extent),
+    };
+}
+
+static bool slab_ray (SDL_FRect rect, SDL_FPoint origin, SDL_FPoint direction, float tmax, float * t) {
+    float tenter = 0.0f;
+    float texit = tmax;
+    const float o[2] = { origin.x, origin.y };
+    const float d[2] = { direction.x, direction.y };
+    const float lo[2] = { rect.x, rect.y };
+    const float hi[2] = { rect.x + rect.w, rect.y + rect.h };
+    for (int axis = 0; axis < 2; axis++) {
+        if (d[axis] == 0.0f) {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+            continue;
+        }
+        const float t0 = (lo[axis] - o[axis]) / d[axis];
+        const float t1 = (hi[axis] - o[axis]) / d[axis];
+        tenter = SDL_max(tenter, SDL_min(t0, t1));
+        texit = SDL_min(texit, SDL_max(t0, t1));
+        if (tenter > texit) return false;
+    }
+    *t = tenter;
+    return true;
+}
+
+Test(bvh, visit_aabb_matches_brute_force) {
+    uint32_t state = 12345;
+    static SDL_FRect rects[TEST_BVH_NRECTS];
+    for (int i = 0; i < TEST_BVH_NRECTS; i++) {
+        rects[i] = random_rect(&state, 2000.0f, 50.0f);
+    }
+    struct bvh * bvh = bvh_new(rects, TEST_BVH_NRECTS);
+    for (int iquery = 0; iquery < TEST_BVH_NQUERIES; iquery++) {
+        const SDL_FRect aabb = random_rect(&state, 2000.0f, 300.0f);
+        struct visits expected = {};
+        for (int i = 0; i < TEST_BVH_NRECTS; i++) {
+            if (is_overlapping(rects[i], aabb)) {
+                count_rect(rects[i], &expected);
+            }
+        }
+        struct visits actual = {};
+        bvh_visit_aabb(bvh, aabb, count_rect, &actual);
+        cr_assert_eq(actual.n, expected.n, "query %d visited %d rectangles, expected %d", iquery, actual.n, expected.n);
+        cr_assert_float_eq(actual.sum, expected.sum, 1e-3, "query %d visited other rectangles than expected", iquery);
+    }
+    bvh_delete(&bvh);
+}
+
+Test(bvh, visit_aabb_visits_more_than_64) {
+    // a dense block of 20 x 20 rectangles, all of which overlap the query
+    SDL_FRect rects[400];
+    for (int i = 0; i < 400; i++) {
+        rects[i] = (SDL_FRect) { .h = 4.0f, .w = 4.0f, .x = 4.0f * (i % 20), .y = 4.0f * (i / 20) };
+    }
+    struct bvh * bvh = bvh_new(rects, 400);
+    struct visits visits = {};
+    bvh_visit_aabb(bvh, (SDL_FRect) { .h = 80.0f, .w = 80.0f, .x = 0.0f, .y = 0.0f }, count_rect, &visits);
+    cr_assert_eq(visits.n, 400);
+    bvh_delete(&bvh);
+}
+
+Test(bvh, visit_aabb_stops_when_asked) {
+    SDL_FRect rects[100];
+    for (int i = 0; i < 100; i++) {
+        rects[i] = (SDL_FRect) { .h = 1.0f, .w = 1.0f, .x = 2.0f * i, .y = 0.0f };
+    }
+    struct bvh * bvh = bvh_new(rects, 100);
+    struct visits visits = { .nstop = 7 };
+    bvh_visit_aabb(bvh, (SDL_FRect) { .h = 1.0f, .w = 200.0f, .x = 0.0f, .y = 0.0f }, count_rect, &visits);
+    cr_assert_eq(visits.n, 7);
+    bvh_delete(&bvh);
+}
+
+Test(bvh, visit_aabb_skips_touching_edges) {
+    const SDL_FRect rect = (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 0.0f, .y = 0.0f };
+    struct bvh * bvh = bvh_new(&rect, 1);
+    struct visits visits = {};
+    bvh_visit_aabb(bvh, (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 10.0f, .y = 0.0f }, count_rect, &visits);
+    cr_assert_eq(visits.n, 0);
+    bvh_delete(&bvh);
+}
+
+Test(bvh, empty) {
+    struct bvh * bvh = bvh_new(nullptr, 0);
+    struct visits visits = {};
+    bvh_visit_aabb(bvh, (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 0.0f, .y = 0.0f }, count_rect, &visits);
+    cr_assert_eq(visits.n, 0);
+    float t = -1.0f;
+    cr_assert_not(bvh_query_ray(bvh, (SDL_FPoint) { 0.0f, 0.0f }, (SDL_FPoint) { 1.0f, 0.0f }, 1.0f, &t));
+    bvh_delete(&bvh);
+}
+
+Test(bvh, query_ray_matches_brute_force) {
+    uint32_t state = 67890;
+    static SDL_FRect rects[TEST_BVH_NRECTS];
+    for (int i = 0; i < TEST_BVH_NRECTS; i++) {
+        rects[i] = random_rect(&state, 2000.0f, 50.0f);
+    }
+    struct bvh * bvh = bvh_new(rects, TEST_BVH_NRECTS);
+    for (int iquery = 0; iquery < TEST_BVH_NQUERIES; iquery++) {
+        const SDL_FPoint origin = (SDL_FPoint) {
+            .x = random_float(&state, 0.0f, 2000.0f),
+            .y = random_float(&state, 0.0f, 2000.0f),
+        };
+        // every fourth ray is parallel to an axis, which takes the slabs' special case
+        SDL_FPoint direction = (SDL_FPoint) {
+            .x = random_float(&state, -1.0f, 1.0f),
+            .y = random_float(&state, -1.0f, 1.0f),
+        };
+        if (iquery % 4 == 0) {
+            direction.y = 0.0f;
+        }
+        const float tmax = random_float(&state, 0.0f, 1000.0f);
+        bool is_hit_expected = false;
+        float t_expected = FLT_MAX;
+        for (int i = 0; i < TEST_BVH_NRECTS; i++) {
+            float t = 0.0f;
+            if (slab_ray(rects[i], origin, direction, tmax, &t) && t < t_expected) {
+                is_hit_expected = true;
+                t_expected = t;
+            }
+        }
+        float t_actual = -1.0f;
+        const bool is_hit_actual = bvh_query_ray(bvh, origin, direction, tmax, &t_actual);
+        cr_assert_eq(is_hit_actual, is_hit_expected, "ray %d: hit %d, expected %d", iquery, is_hit_actual, is_hit_expected);
+        if (is_hit_expected) {
+            cr_assert_float_eq(t_actual, t_expected, 1e-4f, "ray %d: t = %f, expected %f", iquery, t_actual, t_expected);
+        }
+    }
+    bvh_delete(&bvh);
+}
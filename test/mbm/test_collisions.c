@@ -0,0 +1,94 @@
+#include "bvh.h"
+#include "collisions.h"
+#include "SDL3/SDL_rect.h"        // SDL_FPoint, SDL_FRect
+#include <criterion/criterion.h>
+
+static bool is_overlapping (SDL_FRect a, SDL_FRect b);
+
+static bool is_overlapping (SDL_FRect a, SDL_FRect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+Test(collisions, sweep_stops_at_thin_wall) {
+    // a step of 1000 px, e.g. from a long frame, towards a wall that is only 4 px thick
+    const SDL_FRect wall = (SDL_FRect) { .h = 100.0f, .w = 4.0f, .x = 500.0f, .y = -50.0f };
+    struct bvh * bvh = bvh_new(&wall, 1);
+    const SDL_FRect aabb = (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 0.0f, .y = 0.0f };
+    SDL_FPoint normal = {};
+    const float toi = collisions_sweep_aabb(bvh, aabb, (SDL_FPoint) { 1000.0f, 0.0f }, &normal);
+    cr_assert_float_eq(aabb.x + aabb.w + toi * 1000.0f, wall.x, 1e-3f);
+    cr_assert_float_eq(normal.x, -1.0f, 0.0f);
+    cr_assert_float_eq(normal.y, 0.0f, 0.0f);
+    bvh_delete(&bvh);
+}
+
+Test(collisions, sweep_lands_on_thin_platform) {
+    const SDL_FRect platform = (SDL_FRect) { .h = 4.0f, .w = 100.0f, .x = -50.0f, .y = 300.0f };
+    struct bvh * bvh = bvh_new(&platform, 1);
+    const SDL_FRect aabb = (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 0.0f, .y = 0.0f };
+    SDL_FPoint normal = {};
+    const float toi = collisions_sweep_aabb(bvh, aabb, (SDL_FPoint) { 0.0f, 500.0f }, &normal);
+    cr_assert_float_eq(aabb.y + aabb.h + toi * 500.0f, platform.y, 1e-3f);
+    cr_assert_float_eq(normal.y, -1.0f, 0.0f);
+    bvh_delete(&bvh);
+}
+
+Test(collisions, sweep_stops_at_nearest_of_many) {
+    // a row of 300 small colliders, all of them in the swept box; the box moves right to left,
+    // so the nearest collider is the rightmost one, which the hierarchy visits last
+    SDL_FRect colliders[300];
+    for (int i = 0; i < 300; i++) {
+        colliders[i] = (SDL_FRect) { .h = 4.0f, .w = 4.0f, .x = 8.0f * i, .y = 0.0f };
+    }
+    struct bvh * bvh = bvh_new(colliders, 300);
+    const SDL_FRect aabb = (SDL_FRect) { .h = 4.0f, .w = 4.0f, .x = 3000.0f, .y = 0.0f };
+    SDL_FPoint normal = {};
+    const float toi = collisions_sweep_aabb(bvh, aabb, (SDL_FPoint) { -3000.0f, 0.0f }, &normal);
+    const SDL_FRect nearest = colliders[299];
+    cr_assert_float_eq(aabb.x - toi * 3000.0f, nearest.x + nearest.w, 1e-2f);
+    cr_assert_float_eq(normal.x, 1.0f, 0.0f);
+    bvh_delete(&bvh);
+}
+
+Test(collisions, sweep_slides_across_seam) {
+    // two colliders that form one floor; walking along it doesn't hit the seam between them
+    const SDL_FRect floor[2] = {
+        (SDL_FRect) { .h = 32.0f, .w = 64.0f, .x = 0.0f, .y = 100.0f },
+        (SDL_FRect) { .h = 32.0f, .w = 64.0f, .x = 64.0f, .y = 100.0f },
+    };
+    struct bvh * bvh = bvh_new(floor, 2);
+    const SDL_FRect aabb = (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 40.0f, .y = 90.0f };
+    SDL_FPoint normal = {};
+    const float toi = collisions_sweep_aabb(bvh, aabb, (SDL_FPoint) { 50.0f, 0.0f }, &normal);
+    cr_assert_float_eq(toi, 1.0f, 0.0f);
+    cr_assert_float_eq(normal.x, 0.0f, 0.0f);
+    cr_assert_float_eq(normal.y, 0.0f, 0.0f);
+    bvh_delete(&bvh);
+}
+
+Test(collisions, resolve_pushes_out_of_floor) {
+    const SDL_FRect floor = (SDL_FRect) { .h = 32.0f, .w = 320.0f, .x = 0.0f, .y = 100.0f };
+    struct bvh * bvh = bvh_new(&floor, 1);
+    const SDL_FRect aabb = (SDL_FRect) { .h = 10.0f, .w = 10.0f, .x = 40.0f, .y = 92.0f };
+    const SDL_FPoint displacement = collisions_resolve_penetration(bvh, aabb);
+    cr_assert_float_eq(displacement.x, 0.0f, 0.0f);
+    cr_assert_float_eq(displacement.y, -2.0f, 1e-4f);
+    bvh_delete(&bvh);
+}
+
+Test(collisions, resolve_pushes_out_of_many) {
+    // a box that starts out overlapping 100 small colliders ends up overlapping none of them
+    SDL_FRect colliders[100];
+    for (int i = 0; i < 100; i++) {
+        colliders[i] = (SDL_FRect) { .h = 1.0f, .w = 1.0f, .x = 2.0f * (i % 10), .y = 2.0f * (i / 10) };
+    }
+    struct bvh * bvh = bvh_new(colliders, 100);
+    SDL_FRect aabb = (SDL_FRect) { .h = 30.0f, .w = 30.0f, .x = -5.0f, .y = -5.0f };
+    const SDL_FPoint displacement = collisions_resolve_penetration(bvh, aabb);
+    aabb.x += displacement.x;
+    aabb.y += displacement.y;
+    for (int i = 0; i < 100; i++) {
+        cr_assert_not(is_overlapping(colliders[i], aabb), "box still overlaps collider %d", i);
+    }
+    bvh_delete(&bvh);
+}